@@ -0,0 +1,60 @@
+#include "dict/near_words.hpp"
+
+#include <array>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "temp_directory.hpp"
+#include "utils/levenshtein.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_near_words_find") {
+    constexpr size_t nr_words = 500'000;
+    constexpr std::array<std::string_view, 24> syllables = {"ka", "lo", "mi", "ne", "ra", "tu", "sa", "vo", "pe", "di", "ba", "go",
+                                                            "zi", "fu", "he", "ja", "wo", "ly", "qua", "stra", "ein", "ou", "ch", "é"};
+
+    TempDirectory dir;
+    std::string path = (dir.path() / "bench.near").string();
+
+    // as many words as a big Wiktionary language, of one to six syllables
+    std::set<std::string> word_set;
+    unsigned state = 1;
+    while (word_set.size() < nr_words) {
+        std::string word;
+        state = state * 1103515245 + 12345;
+        for (unsigned i = 1 + (state >> 8) % 6; i > 0; --i) {
+            state = state * 1103515245 + 12345;
+            word += syllables[(state >> 8) % syllables.size()];
+        }
+        word_set.insert(word);
+    }
+    std::vector<std::string> words{word_set.begin(), word_set.end()};
+    write_near_words(path, words);
+    NearWords near_words{path};
+
+    // a long word typed with a typo, and the first letters of one being typed
+    for (std::string_view query : {"stramineoukalo", "kal"}) {
+        for (int max_distance : {1, 2}) {
+            BENCHMARK(fmt::format("find_{}_{}", query, max_distance)) {
+                return near_words.find(query, max_distance, 6);
+            };
+        }
+        BENCHMARK(fmt::format("scan_{}_1", query)) {
+            LevenshteinAutomaton automaton{query, 1};
+            int r = 0;
+            for (const std::string& word : words)
+                r += automaton.distance(word) <= 1;
+            return r;
+        };
+    }
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,112 @@
+#include "dict/reader.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/format.hpp"
+#include "dict/writer.hpp"
+#include "temp_directory.hpp"
+#include "utils/database.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_reader_pick_word") {
+    constexpr int nr_words = 200'000;
+
+    TempDirectory dir;
+
+    std::string path = (dir.path() / "contiguous.dict").string();
+    std::string native_path = (dir.path() / "native.dict").string();
+    for (auto [p, format] : {std::pair{path, Format::sqlite}, std::pair{native_path, Format::native}}) {
+        Writer writer{p, format};
+        for (int i = 0; i < nr_words; ++i)
+            writer.add_word(fmt::format("word{}", i), fmt::format("Noun:\n- description of word {}\n\n", i));
+        writer.save();
+    }
+
+    // same words, but tagged as version 1 so the reader falls back to offset scans
+    std::string legacy_path = (dir.path() / "legacy.dict").string();
+    std::filesystem::copy_file(path, legacy_path);
+    Database{legacy_path, false}.exec("PRAGMA user_version=1");
+
+    Reader reader{path};
+    Reader legacy_reader{legacy_path};
+    Reader native_reader{native_path};
+
+    BENCHMARK("offset") {
+        return legacy_reader.pick_word();
+    };
+    BENCHMARK("rowid") {
+        return reader.pick_word();
+    };
+    BENCHMARK("native") {
+        return native_reader.pick_word();
+    };
+
+    BENCHMARK("open_sqlite") {
+        return Reader{path}.pick_word();
+    };
+    BENCHMARK("open_native") {
+        return Reader{native_path}.pick_word();
+    };
+
+    int i = 0;
+    BENCHMARK("find_sqlite") {
+        return reader.find_description(fmt::format("word{}", i++ * 7919 % nr_words));
+    };
+    BENCHMARK("find_native") {
+        return native_reader.find_description(fmt::format("word{}", i++ * 7919 % nr_words));
+    };
+}
+
+TEST_CASE("dict_reader_search") {
+    constexpr int nr_words = 200'000;
+
+    TempDirectory dir;
+
+    // descriptions of a dozen terms out of a few thousand, some much more frequent than others like in real definitions
+    std::vector<std::string> vocabulary;
+    for (int i = 0; i < 5000; ++i)
+        vocabulary.push_back(fmt::format("term{}", i));
+    std::string path = (dir.path() / "sqlite.dict").string();
+    std::string native_path = (dir.path() / "native.dict").string();
+    for (auto [p, format] : {std::pair{path, Format::sqlite}, std::pair{native_path, Format::native}}) {
+        Writer writer{p, format, true};
+        unsigned state = 1;
+        for (int i = 0; i < nr_words; ++i) {
+            std::string description = "Noun:\n-";
+            for (int j = 0; j < 12; ++j) {
+                state = state * 1103515245 + 12345;
+                unsigned x = (state >> 8) % vocabulary.size();
+                description += ' ';
+                description += vocabulary[x * x / vocabulary.size()];
+            }
+            writer.add_word(fmt::format("word{}", i), description);
+        }
+        writer.save();
+    }
+
+    Reader reader{path};
+    Reader native_reader{native_path};
+
+    BENCHMARK("search_rare_sqlite") {
+        return reader.search("term3200 term4050", 20);
+    };
+    BENCHMARK("search_rare_native") {
+        return native_reader.search("term3200 term4050", 20);
+    };
+    BENCHMARK("search_common_sqlite") {
+        return reader.search("term1 term2", 20);
+    };
+    BENCHMARK("search_common_native") {
+        return native_reader.search("term1 term2", 20);
+    };
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,54 @@
+#include "dict/writer.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/format.hpp"
+#include "dict/word.hpp"
+#include "temp_directory.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_writer_add_words") {
+    constexpr int nr_words = 200'000;
+
+    TempDirectory dir;
+    std::string path = (dir.path() / "bench.dict").string();
+
+    // shuffled like words of a dump, so the index is not built in order
+    std::vector<Word> words;
+    for (int i = 0; i < nr_words; ++i)
+        words.push_back({fmt::format("word{}", i * 7919 % nr_words), fmt::format("Noun:\n- description of word {}\n\n", i)});
+
+    BENCHMARK("add_word") {
+        Writer writer{path};
+        for (const Word& word : words)
+            writer.add_word(word.word, word.description);
+        writer.save();
+    };
+    BENCHMARK("add_words") {
+        Writer writer{path};
+        for (size_t i = 0; i < words.size(); i += 100)
+            writer.add_words(std::span{words}.subspan(i, 100));
+        writer.save();
+    };
+    BENCHMARK("add_words_full_text") {
+        Writer writer{path, Format::sqlite, true};
+        for (size_t i = 0; i < words.size(); i += 100)
+            writer.add_words(std::span{words}.subspan(i, 100));
+        writer.save();
+    };
+    BENCHMARK("add_words_native_full_text") {
+        Writer writer{path, Format::native, true};
+        for (size_t i = 0; i < words.size(); i += 100)
+            writer.add_words(std::span{words}.subspan(i, 100));
+        writer.save();
+    };
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,83 @@
+#include "dictgen/gzip.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+#include <zlib.h>
+
+namespace komankondi::dictgen {
+namespace {
+
+/// Lines looking like those of a Wiktionary enterprise dump.
+std::string make_dump(int nr_articles) {
+    std::string r;
+    unsigned state = 1;
+    for (int i = 0; i < nr_articles; ++i) {
+        std::string body;
+        for (int j = 0; j < 40; ++j) {
+            state = state * 1103515245 + 12345;
+            body += fmt::format("<li>definition {} of word{}</li>", (state >> 8) % 1000, i);
+        }
+        r += fmt::format(R"({{"name":"word{}","identifier":{},"article_body":{{"html":"<h2 id=\"English\">English</h2><ol>{}</ol>"}}}})" "\n",
+                         i, i, body);
+    }
+    return r;
+}
+
+std::vector<std::byte> compress(std::span<const std::byte> data) {
+    z_stream stream{};
+    REQUIRE(deflateInit2(&stream, 6, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    std::vector<std::byte> r(deflateBound(&stream, data.size()));
+    stream.next_in = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<unsigned char*>(r.data());
+    stream.avail_out = r.size();
+    REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    r.resize(stream.total_out);
+    deflateEnd(&stream);
+    return r;
+}
+
+/// Feed data in slices of the size the downloader receives.
+size_t decompress(GzipBackend backend, std::span<const std::byte> data) {
+    constexpr size_t slice_size = 65536;
+    GzipDecompressor unzip{backend};
+    std::vector<std::byte> out;
+    size_t r = 0;
+    for (size_t offset = 0; offset < data.size(); offset += slice_size) {
+        unzip(data.subspan(offset, std::min(slice_size, data.size() - offset)), out);
+        r += out.size();
+        out.clear();
+    }
+    unzip({}, out);
+    return r + out.size();
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_gzip") {
+    std::string dump = make_dump(4000);
+    std::vector<std::byte> compressed = compress(std::as_bytes(std::span{dump}));
+
+    for (GzipBackend backend : gzip_backends()) {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(decompress(backend, compressed) == dump.size());
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        fmt::print("{}: {:.0f} MB/s\n", backend, dump.size() / duration.count() / 1e6);
+    }
+
+    for (GzipBackend backend : gzip_backends()) {
+        BENCHMARK(fmt::to_string(backend)) {
+            return decompress(backend, compressed);
+        };
+    }
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,78 @@
+#include "dictgen/language_spec.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dictgen/html.hpp"
+#include "dictgen/json_extract.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+/// Lines looking like those of a Wiktionary enterprise dump, with another language section before the English one.
+std::string make_dump(int nr_articles) {
+    std::string r;
+    unsigned state = 1;
+    for (int i = 0; i < nr_articles; ++i) {
+        std::string body = R"(<h2 id=\"Dutch\">Dutch</h2><h3 id=\"Noun\">Noun</h3><ol><li>other</li></ol>)"
+                           R"(<h2 id=\"English\">English</h2><h3 id=\"Etymology\">Etymology</h3><p>From <i>x</i>.</p>)"
+                           R"(<h3 id=\"Noun\">Noun</h3><p>word</p><ol>)";
+        for (int j = 0; j < 8; ++j) {
+            state = state * 1103515245 + 12345;
+            body += fmt::format(R"(<li>definition {} of <a href=\"./w{}\">word{}</a> &amp; more<dl><dd>example</dd></dl></li>)",
+                                (state >> 8) % 1000, i, i);
+        }
+        body += R"(</ol><h4 id=\"Synonyms\">Synonyms</h4><ul><li>syn</li></ul>)";
+        r += fmt::format(R"({{"name":"word{}","identifier":{},"article_body":{{"html":"{}"}}}})" "\n", i, i, body);
+    }
+    return r;
+}
+
+/// Same as the extraction done for each batch of lines when generating a dictionary.
+size_t extract(std::string_view lines, const LanguageSpec& language_spec) {
+    size_t r = 0;
+    JsonStorage storage;
+    for (auto [word, html] : extract_articles(lines, storage)) {
+        std::string description;
+        for (const ArticleForm& form : parse_article(html, language_spec)) {
+            description += form.name;
+            for (std::string_view definition_html : form.definitions)
+                append_html_text(definition_html, description);
+        }
+        r += description.size();
+    }
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_language_spec_extraction") {
+    LanguageSpec english = find_language_spec("english");
+    std::string dump = make_dump(2000);
+    REQUIRE(extract(dump, english) > 0);
+
+    JsonStorage storage;
+    std::vector<JsonArticle> articles = extract_articles(dump, storage);
+
+    BENCHMARK("extract_articles") {
+        JsonStorage s;
+        return extract_articles(dump, s).size();
+    };
+    BENCHMARK("parse_article") {
+        size_t r = 0;
+        for (const JsonArticle& article : articles)
+            r += parse_article(article.html, english).size();
+        return r;
+    };
+    BENCHMARK("all") {
+        return extract(dump, english);
+    };
+}
+
+}  // namespace komankondi::dictgen
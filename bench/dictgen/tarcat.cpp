@@ -0,0 +1,73 @@
+#include "dictgen/tarcat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+namespace komankondi::dictgen {
+namespace {
+
+constexpr size_t slice_size = 65536;
+
+/// Tar archive of members of various sizes, only the header fields TarCat reads being set.
+std::vector<std::byte> make_tar(int nr_members, size_t* content_size) {
+    std::vector<std::byte> r;
+    *content_size = 0;
+    for (int i = 0; i < nr_members; ++i) {
+        size_t size = 1000 + static_cast<size_t>(i) * 7919 % 3'000'000;
+        std::vector<std::byte> header(512);
+        std::string name = fmt::format("member{}.ndjson", i);
+        std::memcpy(header.data(), name.data(), name.size());
+        std::string size_field = fmt::format("{:011o}", size);
+        std::memcpy(header.data() + 124, size_field.data(), size_field.size());
+        r.insert(r.end(), header.begin(), header.end());
+        r.resize(r.size() + (size + 511) / 512 * 512, std::byte{'x'});
+        *content_size += size;
+    }
+    r.resize(r.size() + 2 * 512);
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_tarcat") {
+    size_t content_size;
+    std::vector<std::byte> tar = make_tar(40, &content_size);
+    std::span<const std::byte> data = tar;
+
+    BENCHMARK("copy") {
+        TarCat tarcat;
+        std::vector<std::byte> out;
+        size_t r = 0;
+        for (size_t offset = 0; offset < data.size(); offset += slice_size) {
+            tarcat(data.subspan(offset, std::min(slice_size, data.size() - offset)), out);
+            r += out.size();
+            out.clear();
+        }
+        REQUIRE(r == content_size);
+        return r;
+    };
+
+    BENCHMARK("views") {
+        TarCat tarcat;
+        std::vector<TarCat::View> views;
+        size_t r = 0;
+        for (size_t offset = 0; offset < data.size(); offset += slice_size) {
+            tarcat.views(data.subspan(offset, std::min(slice_size, data.size() - offset)), views);
+            for (const TarCat::View& view : views)
+                r += view.data.size();
+            views.clear();
+        }
+        REQUIRE(r == content_size);
+        return r;
+    };
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,48 @@
+#include "dictgen/wiktionary.hpp"
+
+#include <filesystem>
+#include <string>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "dictgen/dump_host.hpp"
+#include "dictgen/language_spec.hpp"
+#include "dictgen/synthetic_dump.hpp"
+#include "temp_directory.hpp"
+
+namespace komankondi::dictgen {
+
+/// Whole pipeline, from downloading a dump of about 100 MB of json to saving the dictionary.
+TEST_CASE("dictgen_wiktionary_generate") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "english.dict").string();
+
+    SyntheticDumpOptions dump_options;
+    dump_options.nr_articles = 30'000;
+    DumpHost host{{{"en", "20240101", make_synthetic_dump(dump_options).archive}}};
+
+    LanguageSpec english = find_language_spec("english");
+    GenerateOptions options;
+    options.cache = false;
+    options.incremental = false;
+    options.dump_host = host.origin();
+
+    BENCHMARK("generate") {
+        generate_dictionary(path, english, options);
+    };
+
+    options.gzip_backend = GzipBackend::parallel;
+    BENCHMARK("generate_parallel_gzip") {
+        generate_dictionary(path, english, options);
+    };
+
+    options.gzip_backend = GzipBackend::zlib;
+    options.incremental = true;
+    generate_dictionary(path, english, options);
+    BENCHMARK("regenerate_unchanged") {
+        generate_dictionary(path, english, options);
+    };
+}
+
+}  // namespace komankondi::dictgen
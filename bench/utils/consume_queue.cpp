@@ -0,0 +1,125 @@
+#include "utils/consume_queue.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/guarded.hpp"
+
+namespace komankondi {
+namespace {
+
+/// Mutex and condition variables queue that ConsumeQueue replaced, to compare with.
+template <typename Element>
+struct LockedQueue {
+    explicit LockedQueue(int max_size) :
+            max_size_{max_size} {
+    }
+
+    void close() {
+        shared_.lock()->closed = true;
+        condvar_push_.notify_all();
+        condvar_pop_.notify_all();
+    }
+
+    bool push(Element&& element) {
+        {
+            GuardedHandle<Shared> s = shared_.lock();
+            s.wait(condvar_push_, [&] { return s->closed || std::ssize(s->queue) < max_size_; });
+            if (s->closed)
+                return false;
+            s->queue.push(std::move(element));
+        }
+        condvar_pop_.notify_one();
+        return true;
+    }
+
+    std::optional<Element> pop() {
+        std::optional<Element> r;
+        {
+            GuardedHandle<Shared> s = shared_.lock();
+            s.wait(condvar_pop_, [&] { return s->closed || !s->queue.empty(); });
+            if (s->closed && s->queue.empty())
+                return {};
+            r = std::move(s->queue.front());
+            s->queue.pop();
+        }
+        condvar_push_.notify_one();
+        return r;
+    }
+
+private:
+    int max_size_;
+
+    struct Shared {
+        bool closed = false;
+        std::queue<Element> queue;
+    };
+    Guarded<Shared> shared_;
+
+    std::condition_variable condvar_push_;
+    std::condition_variable condvar_pop_;
+};
+
+constexpr int nr_elements = 200000;
+constexpr int queue_size = 16;
+
+/// Pass elements from producers to consumers, returning their sum.
+template <typename Queue>
+int64_t transfer(int nr_producers, int nr_consumers) {
+    Queue queue{queue_size};
+
+    std::vector<std::future<int64_t>> consumers;
+    for (int i = 0; i < nr_consumers; ++i) {
+        consumers.push_back(std::async(std::launch::async, [&] {
+            int64_t r = 0;
+            while (std::optional<int> element = queue.pop())
+                r += *element;
+            return r;
+        }));
+    }
+    std::vector<std::future<void>> producers;
+    for (int i = 0; i < nr_producers; ++i) {
+        producers.push_back(std::async(std::launch::async, [&, i] {
+            for (int j = i; j < nr_elements; j += nr_producers)
+                queue.push(int{j});
+        }));
+    }
+    for (std::future<void>& producer : producers)
+        producer.get();
+    queue.close();
+
+    int64_t r = 0;
+    for (std::future<int64_t>& consumer : consumers)
+        r += consumer.get();
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("utils_consume_queue") {
+    BENCHMARK("locked 1:1") {
+        return transfer<LockedQueue<int>>(1, 1);
+    };
+    BENCHMARK("spsc 1:1") {
+        return transfer<ConsumeQueue<int, QueueMode::spsc>>(1, 1);
+    };
+    BENCHMARK("mpmc 1:1") {
+        return transfer<ConsumeQueue<int, QueueMode::mpmc>>(1, 1);
+    };
+    BENCHMARK("locked 4:4") {
+        return transfer<LockedQueue<int>>(4, 4);
+    };
+    BENCHMARK("mpmc 4:4") {
+        return transfer<ConsumeQueue<int, QueueMode::mpmc>>(4, 4);
+    };
+}
+
+}  // namespace komankondi
@@ -0,0 +1,60 @@
+#include "utils/newlines.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi {
+namespace {
+
+std::string make_text(unsigned min_line, unsigned max_line) {
+    std::string r;
+    unsigned state = 1;
+    while (r.size() < (16 << 20)) {
+        state = state * 1103515245 + 12345;
+        r.append(min_line + (state >> 8) % (max_line - min_line), 'x');
+        r += '\n';
+    }
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("utils_newlines") {
+    std::string text;
+    SECTION("long lines, like records of a dump") {
+        text = make_text(500, 8500);
+    }
+    SECTION("short lines") {
+        text = make_text(10, 80);
+    }
+
+    std::vector<size_t> offsets;
+    BENCHMARK("find_newlines") {
+        offsets.clear();
+        find_newlines(text, offsets);
+        return offsets.size();
+    };
+    BENCHMARK("string_view::find") {
+        offsets.clear();
+        std::string_view view = text;
+        for (size_t pos = view.find('\n'); pos != std::string_view::npos; pos = view.find('\n', pos + 1))
+            offsets.push_back(pos);
+        return offsets.size();
+    };
+    BENCHMARK("byte_loop") {
+        offsets.clear();
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '\n')
+                offsets.push_back(i);
+        }
+        return offsets.size();
+    };
+}
+
+}  // namespace komankondi
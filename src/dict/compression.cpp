@@ -0,0 +1,115 @@
+#include "compression.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include "utils/exception.hpp"
+#include "utils/log.hpp"
+
+namespace komankondi::dict {
+namespace {
+
+constexpr int compression_level = 9;
+constexpr size_t max_dictionary_size = 112 * 1024;
+
+void check(size_t code, std::string_view what) {
+    if (ZSTD_isError(code))
+        throw Exception{"Could not {}: {}", what, ZSTD_getErrorName(code)};
+}
+
+}  // namespace
+
+
+DescriptionCompressor::DescriptionCompressor(std::span<const std::string> samples) :
+        ctx_{ZSTD_createCCtx()} {
+    if (!ctx_)
+        throw Exception{"Could not create compression context"};
+
+    std::string buffer;
+    std::vector<size_t> sizes;
+    for (const std::string& sample : samples) {
+        buffer += sample;
+        sizes.push_back(sample.size());
+    }
+    dictionary_.resize(max_dictionary_size);
+    size_t size = ZDICT_trainFromBuffer(dictionary_.data(), dictionary_.size(), buffer.data(), sizes.data(), sizes.size());
+    if (ZDICT_isError(size)) {
+        log::debug("Compressing descriptions without dictionary: {}", ZDICT_getErrorName(size));
+        dictionary_.clear();
+    }
+    else {
+        dictionary_.resize(size);
+        log::debug("Trained compression dictionary of {} bytes on {} descriptions", size, samples.size());
+    }
+
+    // the dictionary and sizes are known when decompressing, no need to repeat them in each description
+    check(ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_dictIDFlag, 0), "set compression parameter");
+    check(ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_checksumFlag, 0), "set compression parameter");
+    check(ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_compressionLevel, compression_level), "set compression parameter");
+    if (!dictionary_.empty()) {
+        cdict_.reset(ZSTD_createCDict(dictionary_.data(), dictionary_.size(), compression_level));
+        if (!cdict_)
+            throw Exception{"Could not load compression dictionary"};
+        check(ZSTD_CCtx_refCDict(ctx_.get(), cdict_.get()), "use compression dictionary");
+    }
+}
+
+std::span<const std::byte> DescriptionCompressor::dictionary() const {
+    return dictionary_;
+}
+
+std::vector<std::byte> DescriptionCompressor::operator()(std::string_view description) {
+    std::vector<std::byte> r(ZSTD_compressBound(description.size()));
+    size_t size = ZSTD_compress2(ctx_.get(), r.data(), r.size(), description.data(), description.size());
+    check(size, "compress description");
+    r.resize(size);
+    return r;
+}
+
+
+DescriptionDecompressor::DescriptionDecompressor(std::span<const std::byte> dictionary) :
+        ctx_{ZSTD_createDCtx()} {
+    if (!ctx_)
+        throw Exception{"Could not create decompression context"};
+    if (!dictionary.empty()) {
+        ddict_.reset(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+        if (!ddict_)
+            throw Exception{"Could not load compression dictionary"};
+        check(ZSTD_DCtx_refDDict(ctx_.get(), ddict_.get()), "use compression dictionary");
+    }
+}
+
+std::string DescriptionDecompressor::operator()(std::span<const std::byte> data) {
+    unsigned long long size = ZSTD_getFrameContentSize(data.data(), data.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+        throw Exception{"Could not decompress description: invalid frame"};
+
+    std::string r(size, '\0');
+    check(ZSTD_decompressDCtx(ctx_.get(), r.data(), r.size(), data.data(), data.size()), "decompress description");
+    return r;
+}
+
+}  // namespace komankondi::dict
+
+
+void std::default_delete<ZSTD_CCtx>::operator()(ZSTD_CCtx* ptr) const {
+    ZSTD_freeCCtx(ptr);
+}
+
+void std::default_delete<ZSTD_DCtx>::operator()(ZSTD_DCtx* ptr) const {
+    ZSTD_freeDCtx(ptr);
+}
+
+void std::default_delete<ZSTD_CDict>::operator()(ZSTD_CDict* ptr) const {
+    ZSTD_freeCDict(ptr);
+}
+
+void std::default_delete<ZSTD_DDict>::operator()(ZSTD_DDict* ptr) const {
+    ZSTD_freeDDict(ptr);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zstd.h>
+
+template <>
+struct std::default_delete<ZSTD_CCtx> {
+    void operator()(ZSTD_CCtx* ptr) const;
+};
+
+template <>
+struct std::default_delete<ZSTD_DCtx> {
+    void operator()(ZSTD_DCtx* ptr) const;
+};
+
+template <>
+struct std::default_delete<ZSTD_CDict> {
+    void operator()(ZSTD_CDict* ptr) const;
+};
+
+template <>
+struct std::default_delete<ZSTD_DDict> {
+    void operator()(ZSTD_DDict* ptr) const;
+};
+
+
+namespace komankondi::dict {
+
+/// Compresses descriptions with a zstd dictionary trained on samples of them, since they are short and repetitive.
+struct DescriptionCompressor {
+    /// Without dictionary if samples are too few to train one.
+    explicit DescriptionCompressor(std::span<const std::string> samples);
+
+    std::span<const std::byte> dictionary() const;
+
+    std::vector<std::byte> operator()(std::string_view description);
+
+private:
+    std::vector<std::byte> dictionary_;
+    std::unique_ptr<ZSTD_CCtx> ctx_;
+    std::unique_ptr<ZSTD_CDict> cdict_;
+};
+
+
+struct DescriptionDecompressor {
+    explicit DescriptionDecompressor(std::span<const std::byte> dictionary);
+
+    std::string operator()(std::span<const std::byte> data);
+
+private:
+    std::unique_ptr<ZSTD_DCtx> ctx_;
+    std::unique_ptr<ZSTD_DDict> ddict_;
+};
+
+}  // namespace komankondi::dict
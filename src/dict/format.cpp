@@ -0,0 +1,17 @@
+#include "format.hpp"
+
+#include <string_view>
+
+#include "utils/exception.hpp"
+
+namespace komankondi::dict {
+
+std::string_view format_as(Format format) {
+    switch (format) {
+    case Format::sqlite: return "sqlite";
+    case Format::native: return "native";
+    }
+    throw Exception{"Could not format unknown dictionary format {}", static_cast<int>(format)};
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+
+namespace komankondi::dict {
+
+enum class Format {
+    sqlite,  ///< SQLite database
+    native,  ///< read-only file made to be memory-mapped
+};
+
+std::string_view format_as(Format format);
+
+}  // namespace komankondi::dict
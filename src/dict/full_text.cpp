@@ -0,0 +1,26 @@
+#include "full_text.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace komankondi::dict {
+
+std::vector<std::string> tokenize(std::string_view text) {
+    std::vector<std::string> r;
+    bool in_term = false;
+    for (char c : text) {
+        bool term_char = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+        if (!term_char) {
+            in_term = false;
+            continue;
+        }
+        if (!in_term)
+            r.emplace_back();
+        in_term = true;
+        r.back() += c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return r;
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace komankondi::dict {
+
+/// Terms of text, split and case-folded like the ascii tokenizer of SQLite FTS5 so that both formats find the same words:
+/// runs of ASCII letters, digits and non-ASCII bytes, with ASCII letters lowercased.
+std::vector<std::string> tokenize(std::string_view text);
+
+}  // namespace komankondi::dict
@@ -0,0 +1,369 @@
+#include "native.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "dict/full_text.hpp"
+#include "dict/word.hpp"
+#include "utils/exception.hpp"
+#include "utils/file.hpp"
+#include "utils/scope_exit.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dict {
+namespace {
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t hash_word(std::string_view word) {
+    uint64_t r = 0xcbf29ce484222325;
+    for (unsigned char c : word) {
+        r ^= c;
+        r *= 0x100000001b3;
+    }
+    return mix(r);
+}
+
+uint32_t bucket_of(uint64_t hash, uint32_t nr_buckets) {
+    return hash % nr_buckets;
+}
+
+uint32_t slot_of(uint64_t hash, uint32_t displacement, uint32_t nr_words) {
+    return mix(hash + (displacement + uint64_t{1}) * 0x9e3779b97f4a7c15) % nr_words;
+}
+
+/// Hash and displace: buckets of words are placed from the biggest one, each with the first seed sending all its words to free slots.
+void build_perfect_hash(std::span<const uint64_t> hashes, std::vector<uint32_t>& displacements, std::vector<uint32_t>& slots) {
+    constexpr uint32_t max_displacement = 1 << 28;
+
+    uint32_t nr_words = hashes.size();
+    uint32_t nr_buckets = nr_words / 4 + 1;
+
+    std::vector<std::vector<uint32_t>> buckets(nr_buckets);
+    for (uint32_t i = 0; i < nr_words; ++i)
+        buckets[bucket_of(hashes[i], nr_buckets)].push_back(i);
+
+    std::vector<uint32_t> order(nr_buckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    displacements.assign(nr_buckets, 0);
+    slots.assign(nr_words, 0);
+    std::vector<bool> taken(nr_words);
+    std::vector<uint32_t> candidates;
+    for (uint32_t bucket : order) {
+        const std::vector<uint32_t>& words = buckets[bucket];
+        if (words.empty())
+            break;
+
+        for (uint32_t displacement = 0;; ++displacement) {
+            if (displacement == max_displacement)
+                throw Exception{"Could not build dictionary index: no seed found for {} words", words.size()};
+
+            candidates.clear();
+            for (uint32_t word : words) {
+                uint32_t slot = slot_of(hashes[word], displacement, nr_words);
+                if (taken[slot] || std::find(candidates.begin(), candidates.end(), slot) != candidates.end())
+                    break;
+                candidates.push_back(slot);
+            }
+            if (candidates.size() < words.size())
+                continue;
+
+            for (size_t i = 0; i < words.size(); ++i) {
+                taken[candidates[i]] = true;
+                slots[candidates[i]] = words[i];
+            }
+            displacements[bucket] = displacement;
+            break;
+        }
+    }
+}
+
+/// Terms of text sorted, with the number of times each appears.
+std::vector<std::pair<std::string, uint32_t>> count_terms(std::string_view text) {
+    std::vector<std::string> terms = tokenize(text);
+    std::sort(terms.begin(), terms.end());
+    std::vector<std::pair<std::string, uint32_t>> r;
+    for (std::string& term : terms) {
+        if (!r.empty() && r.back().first == term)
+            ++r.back().second;
+        else
+            r.emplace_back(std::move(term), 1);
+    }
+    return r;
+}
+
+template <typename T>
+std::span<const T> map_table(boost::interprocess::mapped_region& region, uint64_t pos, uint64_t size) {
+    if (pos % alignof(T) != 0 || pos > region.get_size() || size > (region.get_size() - pos) / sizeof(T))
+        throw Exception{"Could not open dictionary: invalid table position"};
+    return {reinterpret_cast<const T*>(static_cast<const char*>(region.get_address()) + pos), size};
+}
+
+/// Read and check the header, and map the compression dictionary that follows the other tables.
+std::span<const std::byte> map_header_and_dictionary(boost::interprocess::mapped_region& region, NativeHeader& header) {
+    if (region.get_size() < sizeof(NativeHeader))
+        throw Exception{"Could not open dictionary: file is too small"};
+    std::memcpy(&header, region.get_address(), sizeof(NativeHeader));
+    if (header.magic != native_magic)
+        throw Exception{"Could not open dictionary: not a native dictionary"};
+    if (header.version != native_version)
+        throw Exception{"Could not open dictionary: unsupported version {}", header.version};
+    if (header.size != region.get_size())
+        throw Exception{"Could not open dictionary: file size is {}, expected {}", region.get_size(), header.size};
+    return map_table<std::byte>(region, header.dictionary_pos, header.size - std::min(header.dictionary_pos, header.size));
+}
+
+}  // namespace
+
+
+bool is_native_dictionary(ZStringView path) {
+    std::vector<char> magic = File{path, File::Mode::read | File::Mode::binary}.read<char>(native_magic.size());
+    return std::equal(magic.begin(), magic.end(), native_magic.begin(), native_magic.end());
+}
+
+
+NativeWriter::NativeWriter(ZStringView path, bool full_text) :
+        file_{path, File::Mode::write | File::Mode::truncate | File::Mode::binary},
+        full_text_{full_text} {
+    // header is written once everything else is known
+    NativeHeader header{};
+    file_.write(std::span<const NativeHeader>{&header, 1});
+}
+
+void NativeWriter::add_word(std::string_view word, std::span<const std::byte> description, std::string_view text) {
+    if (hashes_.size() == UINT32_MAX)
+        throw Exception{"Could not add word {}: too many words", word};
+
+    if (full_text_) {
+        uint32_t index = hashes_.size();
+        uint32_t length = 0;
+        for (auto& [term, count] : count_terms(text)) {
+            std::vector<uint32_t>& postings = postings_[std::move(term)];
+            postings.push_back(index);
+            postings.push_back(count);
+            length += count;
+        }
+        lengths_.push_back(length);
+    }
+
+    file_.write(std::span{word.data(), word.size()});
+    offsets_.push_back(offsets_.back() + word.size());
+    file_.write(description);
+    offsets_.push_back(offsets_.back() + description.size());
+    hashes_.push_back(hash_word(word));
+}
+
+void NativeWriter::save(std::span<const std::byte> dictionary) {
+    std::vector<uint32_t> displacements;
+    std::vector<uint32_t> slots;
+    build_perfect_hash(hashes_, displacements, slots);
+
+    // terms are sorted to be found by binary search, each with the postings of words added in order
+    std::vector<std::unordered_map<std::string, std::vector<uint32_t>>::const_iterator> terms;
+    terms.reserve(postings_.size());
+    for (auto it = postings_.cbegin(); it != postings_.cend(); ++it)
+        terms.push_back(it);
+    std::sort(terms.begin(), terms.end(), [](const auto& a, const auto& b) { return a->first < b->first; });
+    if (terms.size() >= UINT32_MAX)
+        throw Exception{"Could not build full-text index: too many terms"};
+
+    std::string term_blob;
+    std::vector<uint64_t> term_offsets{0};
+    std::vector<uint64_t> posting_offsets{0};
+    std::vector<uint32_t> postings;
+    for (const auto& it : terms) {
+        term_blob += it->first;
+        term_offsets.push_back(term_blob.size());
+        postings.insert(postings.end(), it->second.begin(), it->second.end());
+        posting_offsets.push_back(postings.size() / 2);
+    }
+
+    NativeHeader header{};
+    header.magic = native_magic;
+    header.version = native_version;
+    header.nr_words = hashes_.size();
+    header.nr_buckets = displacements.size();
+    header.flags = full_text_ ? native_flag_full_text : 0;
+    header.nr_terms = terms.size();
+    header.blob_pos = sizeof(NativeHeader);
+
+    uint64_t pos = header.blob_pos + offsets_.back();
+    auto pad = [&] {
+        std::vector<char> padding((8 - pos % 8) % 8);
+        file_.write<char>(padding);
+        pos += padding.size();
+    };
+    auto write_table = [&]<typename T>(uint64_t& table_pos, std::span<const T> table) {
+        table_pos = pos;
+        file_.write<T>(table);
+        pos += table.size_bytes();
+    };
+
+    pad();
+    write_table(header.offsets_pos, std::span<const uint64_t>{offsets_});
+    write_table(header.displacements_pos, std::span<const uint32_t>{displacements});
+    write_table(header.slots_pos, std::span<const uint32_t>{slots});
+    write_table(header.terms_pos, std::span<const char>{term_blob});
+    pad();
+    write_table(header.term_offsets_pos, std::span<const uint64_t>{term_offsets});
+    write_table(header.posting_offsets_pos, std::span<const uint64_t>{posting_offsets});
+    write_table(header.postings_pos, std::span<const uint32_t>{postings});
+    write_table(header.lengths_pos, std::span<const uint32_t>{lengths_});
+    write_table(header.dictionary_pos, dictionary);
+    header.size = pos;
+
+    file_.seek(0);
+    file_.write(std::span<const NativeHeader>{&header, 1});
+    file_.sync();
+    file_ = {};
+}
+
+
+NativeReader::NativeReader(ZStringView path) :
+        file_{path.data(), boost::interprocess::read_only},
+        region_{file_, boost::interprocess::read_only},
+        decompress_{map_header_and_dictionary(region_, header_)} {
+    std::span<const char> blob = map_table<char>(region_, header_.blob_pos, header_.offsets_pos - header_.blob_pos);
+    blob_ = {blob.data(), blob.size()};
+    offsets_ = map_table<uint64_t>(region_, header_.offsets_pos, 2 * uint64_t{header_.nr_words} + 1);
+    displacements_ = map_table<uint32_t>(region_, header_.displacements_pos, header_.nr_buckets);
+    slots_ = map_table<uint32_t>(region_, header_.slots_pos, header_.nr_words);
+    if (header_.nr_buckets == 0)
+        throw Exception{"Could not open dictionary: no hash bucket"};
+
+    if (header_.flags & native_flag_full_text) {
+        std::span<const char> terms = map_table<char>(region_, header_.terms_pos, header_.term_offsets_pos - std::min(header_.terms_pos, header_.term_offsets_pos));
+        terms_ = {terms.data(), terms.size()};
+        term_offsets_ = map_table<uint64_t>(region_, header_.term_offsets_pos, uint64_t{header_.nr_terms} + 1);
+        posting_offsets_ = map_table<uint64_t>(region_, header_.posting_offsets_pos, uint64_t{header_.nr_terms} + 1);
+        postings_ = map_table<uint32_t>(region_, header_.postings_pos, 2 * posting_offsets_.back());
+        lengths_ = map_table<uint32_t>(region_, header_.lengths_pos, header_.nr_words);
+    }
+}
+
+int NativeReader::nr_words() {
+    return header_.nr_words;
+}
+
+Word NativeReader::word(int index) {
+    return {std::string{blob_at(2 * index)}, decompress_(std::as_bytes(std::span{blob_at(2 * index + 1)}))};
+}
+
+std::optional<std::string> NativeReader::find_description(std::string_view word) {
+    if (header_.nr_words == 0)
+        return {};
+
+    uint64_t hash = hash_word(word);
+    uint32_t displacement = displacements_[bucket_of(hash, header_.nr_buckets)];
+    uint32_t index = slots_[slot_of(hash, displacement, header_.nr_words)];
+    if (index >= header_.nr_words)
+        throw Exception{"Could not find word in dictionary: invalid slot"};
+    if (blob_at(2 * index) != word)
+        return {};
+    return decompress_(std::as_bytes(std::span{blob_at(2 * index + 1)}));
+}
+
+std::vector<Word> NativeReader::search(std::string_view query, int limit) {
+    // same ranking as the bm25 function of SQLite FTS5, so that both formats give the same results
+    constexpr double k1 = 1.2;
+    constexpr double b = 0.75;
+
+    if (!(header_.flags & native_flag_full_text))
+        throw Exception{"Could not search dictionary: it has no full-text index"};
+    if (header_.nr_words == 0 || limit <= 0)
+        return {};
+
+    if (average_length_ == 0) {
+        average_length_ = std::accumulate(lengths_.begin(), lengths_.end(), 0.0) / header_.nr_words;
+        scores_.resize(header_.nr_words);
+    }
+
+    ScopeExit scores_resetter{[&] {
+        for (uint32_t match : matches_)
+            scores_[match] = 0;
+        matches_.clear();
+    }};
+
+    std::vector<std::string> terms = tokenize(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    for (const std::string& term : terms) {
+        uint32_t index = *std::ranges::partition_point(std::views::iota(uint32_t{0}, header_.nr_terms),
+                                                       [&](uint32_t i) { return term_at(i) < term; });
+        if (index == header_.nr_terms || term_at(index) != term)
+            continue;
+
+        std::span<const uint32_t> postings = postings_at(index);
+        double nr_matches = postings.size() / 2;
+        double idf = std::log((header_.nr_words - nr_matches + 0.5) / (nr_matches + 0.5));
+        if (idf <= 0)
+            idf = 1e-6;
+        for (size_t i = 0; i < postings.size(); i += 2) {
+            uint32_t match = postings[i];
+            double count = postings[i + 1];
+            if (match >= header_.nr_words)
+                throw Exception{"Could not search dictionary: invalid posting"};
+            if (scores_[match] == 0)
+                matches_.push_back(match);
+            scores_[match] += idf * count * (k1 + 1) / (count + k1 * (1 - b + b * lengths_[match] / average_length_));
+        }
+    }
+
+    auto end = matches_.begin() + std::min<size_t>(limit, matches_.size());
+    std::partial_sort(matches_.begin(), end, matches_.end(), [&](uint32_t x, uint32_t y) {
+        return scores_[x] != scores_[y] ? scores_[x] > scores_[y] : x < y;
+    });
+    std::vector<Word> r;
+    for (auto it = matches_.begin(); it != end; ++it)
+        r.push_back(word(*it));
+    return r;
+}
+
+std::string_view NativeReader::blob_at(int index) const {
+    uint64_t begin = offsets_[index];
+    uint64_t end = offsets_[index + 1];
+    if (begin > end || end > blob_.size())
+        throw Exception{"Could not read dictionary: invalid offsets"};
+    return blob_.substr(begin, end - begin);
+}
+
+std::string_view NativeReader::term_at(uint32_t index) const {
+    uint64_t begin = term_offsets_[index];
+    uint64_t end = term_offsets_[index + 1];
+    if (begin > end || end > terms_.size())
+        throw Exception{"Could not search dictionary: invalid term offsets"};
+    return terms_.substr(begin, end - begin);
+}
+
+std::span<const uint32_t> NativeReader::postings_at(uint32_t index) const {
+    uint64_t begin = posting_offsets_[index];
+    uint64_t end = posting_offsets_[index + 1];
+    if (begin > end || end > postings_.size() / 2)
+        throw Exception{"Could not search dictionary: invalid posting offsets"};
+    return postings_.subspan(2 * begin, 2 * (end - begin));
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "dict/compression.hpp"
+#include "dict/reader.hpp"
+#include "dict/word.hpp"
+#include "utils/file.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dict {
+
+/// Native dictionaries are made of this header, the blob of words and their compressed descriptions,
+/// then tables locating them in the blob, a minimal perfect hash of words, an optional full-text index and the compression dictionary.
+struct NativeHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t nr_words;
+    uint32_t nr_buckets;
+    uint32_t flags;
+    uint32_t nr_terms;
+    uint32_t padding;
+    uint64_t blob_pos;
+    uint64_t offsets_pos;          ///< 2 * nr_words + 1 uint64_t, word i is at [2i, 2i+1) in the blob and its description at [2i+1, 2i+2)
+    uint64_t displacements_pos;    ///< nr_buckets uint32_t, seeds of the hash of words in each bucket
+    uint64_t slots_pos;            ///< nr_words uint32_t, index of the word hashed to each slot
+    uint64_t terms_pos;            ///< sorted terms of descriptions, one after the other
+    uint64_t term_offsets_pos;     ///< nr_terms + 1 uint64_t, term i is at [i, i+1) in the terms
+    uint64_t posting_offsets_pos;  ///< nr_terms + 1 uint64_t, postings of term i are at [i, i+1) in the postings
+    uint64_t postings_pos;         ///< pairs of uint32_t, index of a word whose description has the term and how many times
+    uint64_t lengths_pos;          ///< nr_words uint32_t, number of terms of each description
+    uint64_t dictionary_pos;
+    uint64_t size;
+};
+
+constexpr std::array<char, 8> native_magic{'K', 'M', 'K', 'D', 'I', 'C', 'T', '\0'};
+constexpr uint32_t native_version = 3;
+constexpr uint32_t native_flag_full_text = 1 << 0;  ///< the tables of the full-text index are filled
+
+bool is_native_dictionary(ZStringView path);
+
+
+struct NativeWriter {
+    NativeWriter(ZStringView path, bool full_text = false);
+
+    /// text is the uncompressed description, only used with full_text.
+    void add_word(std::string_view word, std::span<const std::byte> description, std::string_view text = {});
+    void save(std::span<const std::byte> dictionary);
+
+private:
+    File file_;
+    std::vector<uint64_t> offsets_{0};
+    std::vector<uint64_t> hashes_;
+    bool full_text_;
+    std::unordered_map<std::string, std::vector<uint32_t>> postings_;
+    std::vector<uint32_t> lengths_;
+};
+
+
+struct NativeReader : Reader::Impl {
+    NativeReader(ZStringView path);
+
+    int nr_words() override;
+    Word word(int index) override;
+    std::optional<std::string> find_description(std::string_view word) override;
+    std::vector<Word> search(std::string_view query, int limit) override;
+
+private:
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+
+    NativeHeader header_;
+    std::string_view blob_;
+    std::span<const uint64_t> offsets_;
+    std::span<const uint32_t> displacements_;
+    std::span<const uint32_t> slots_;
+    std::string_view terms_;
+    std::span<const uint64_t> term_offsets_;
+    std::span<const uint64_t> posting_offsets_;
+    std::span<const uint32_t> postings_;
+    std::span<const uint32_t> lengths_;
+    DescriptionDecompressor decompress_;
+
+    double average_length_ = 0;
+    std::vector<double> scores_;  ///< by word index, only non-zero during a search
+    std::vector<uint32_t> matches_;
+
+    std::string_view blob_at(int index) const;
+    std::string_view term_at(uint32_t index) const;
+    std::span<const uint32_t> postings_at(uint32_t index) const;
+};
+
+}  // namespace komankondi::dict
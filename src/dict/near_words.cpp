@@ -0,0 +1,148 @@
+#include "near_words.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fmt/core.h>
+
+#include "utils/exception.hpp"
+#include "utils/file.hpp"
+#include "utils/levenshtein.hpp"
+#include "utils/utf8.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dict {
+
+std::string near_words_path(std::string_view dictionary_path) {
+    return fmt::format("{}.near", dictionary_path);
+}
+
+void write_near_words(ZStringView path, std::vector<std::string> words) {
+    if (words.size() >= UINT32_MAX)
+        throw Exception{"Could not write near words: too many words"};
+    std::sort(words.begin(), words.end());
+
+    NearWordsHeader header{};
+    header.magic = near_words_magic;
+    header.version = near_words_version;
+    header.nr_words = words.size();
+
+    std::vector<uint64_t> offsets{0};
+    std::string blob;
+    for (const std::string& word : words) {
+        blob += word;
+        offsets.push_back(blob.size());
+    }
+    header.size = sizeof(NearWordsHeader) + offsets.size() * sizeof(uint64_t) + blob.size();
+
+    File file{path, File::Mode::write | File::Mode::truncate | File::Mode::binary};
+    file.write(std::span<const NearWordsHeader>{&header, 1});
+    file.write<uint64_t>(offsets);
+    file.write<char>(blob);
+    file.sync();
+}
+
+
+NearWords::NearWords(ZStringView path) :
+        file_{path.data(), boost::interprocess::read_only},
+        region_{file_, boost::interprocess::read_only} {
+    if (region_.get_size() < sizeof(NearWordsHeader))
+        throw Exception{"Could not open near words: file is too small"};
+    std::memcpy(&header_, region_.get_address(), sizeof(NearWordsHeader));
+    if (header_.magic != near_words_magic)
+        throw Exception{"Could not open near words: not a near words index"};
+    if (header_.version != near_words_version)
+        throw Exception{"Could not open near words: unsupported version {}", header_.version};
+    if (header_.size != region_.get_size())
+        throw Exception{"Could not open near words: file size is {}, expected {}", region_.get_size(), header_.size};
+
+    uint64_t blob_pos = sizeof(NearWordsHeader) + (uint64_t{header_.nr_words} + 1) * sizeof(uint64_t);
+    if (blob_pos > header_.size)
+        throw Exception{"Could not open near words: file is too small for {} words", header_.nr_words};
+    const char* data = static_cast<const char*>(region_.get_address());
+    offsets_ = {reinterpret_cast<const uint64_t*>(data + sizeof(NearWordsHeader)), uint64_t{header_.nr_words} + 1};
+    blob_ = {data + blob_pos, header_.size - blob_pos};
+}
+
+int NearWords::nr_words() const {
+    return header_.nr_words;
+}
+
+std::vector<NearWords::Match> NearWords::find(std::string_view word, int max_distance, int limit) const {
+    LevenshteinAutomaton automaton{word, max_distance};
+
+    // states[d] is reached through the first d code points of the last word read, that end at ends[d - 1] in it
+    std::vector<LevenshteinAutomaton::State> states{automaton.start()};
+    std::u32string prefix;
+    std::vector<size_t> ends;
+    std::vector<std::pair<int, uint32_t>> matches;
+
+    for (uint32_t i = 0; i < header_.nr_words;) {
+        std::string_view candidate = word_at(i);
+
+        size_t pos = 0;
+        size_t depth = 0;
+        for (; depth < prefix.size() && pos < candidate.size(); ++depth) {
+            size_t end = pos;
+            if (next_code_point(candidate, end) != prefix[depth] || end != ends[depth])
+                break;
+            pos = end;
+        }
+        prefix.resize(depth);
+        ends.resize(depth);
+
+        bool dead = false;
+        while (pos < candidate.size()) {
+            prefix += next_code_point(candidate, pos);
+            ends.push_back(pos);
+            if (states.size() <= prefix.size())
+                states.emplace_back();
+            automaton.step(states[prefix.size() - 1], prefix.back(), states[prefix.size()]);
+            if (!automaton.can_match(states[prefix.size()])) {
+                dead = true;
+                break;
+            }
+        }
+
+        if (!dead) {
+            if (int distance = automaton.distance(states[prefix.size()]); distance <= max_distance)
+                matches.emplace_back(distance, i);
+            ++i;
+            continue;
+        }
+
+        // words are sorted, so those starting with the same dead end follow this one
+        std::string_view dead_end = candidate.substr(0, pos);
+        i = *std::ranges::partition_point(std::views::iota(i + 1, header_.nr_words),
+                                          [&](uint32_t j) { return word_at(j).starts_with(dead_end); });
+        prefix.pop_back();
+        ends.pop_back();
+    }
+
+    auto end = matches.begin() + std::clamp<ptrdiff_t>(limit, 0, std::ssize(matches));
+    std::partial_sort(matches.begin(), end, matches.end());
+    std::vector<Match> r;
+    for (auto it = matches.begin(); it != end; ++it)
+        r.push_back({std::string{word_at(it->second)}, it->first});
+    return r;
+}
+
+std::string_view NearWords::word_at(uint32_t index) const {
+    uint64_t begin = offsets_[index];
+    uint64_t end = offsets_[index + 1];
+    if (begin > end || end > blob_.size())
+        throw Exception{"Could not read near words: invalid offsets"};
+    return blob_.substr(begin, end - begin);
+}
+
+}  // namespace komankondi::dict
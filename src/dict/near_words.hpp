@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dict {
+
+/// Near words indexes are made of this header, a table locating words in the blob that follows, and the blob of words sorted.
+struct NearWordsHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t nr_words;
+    uint64_t size;
+};
+
+constexpr std::array<char, 8> near_words_magic{'K', 'M', 'K', 'N', 'E', 'A', 'R', '\0'};
+constexpr uint32_t near_words_version = 1;
+
+/// Where the near words index of the dictionary at dictionary_path is.
+std::string near_words_path(std::string_view dictionary_path);
+
+void write_near_words(ZStringView path, std::vector<std::string> words);
+
+
+/// Words of a dictionary sorted in a file next to it, to find those within a few edits of any string.
+/// A Levenshtein automaton is run over them like over a trie: the states reached through a prefix are computed once
+/// for all the words starting with it, and they are all skipped at once when none of them can match.
+struct NearWords {
+    struct Match {
+        std::string word;
+        int distance;
+    };
+
+    NearWords(ZStringView path);
+
+    int nr_words() const;
+
+    /// At most limit words within max_distance edits of word, the nearest first, then in order.
+    std::vector<Match> find(std::string_view word, int max_distance, int limit) const;
+
+private:
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+
+    NearWordsHeader header_;
+    std::span<const uint64_t> offsets_;  ///< nr_words + 1, word i is at [i, i+1) in the blob
+    std::string_view blob_;
+
+    std::string_view word_at(uint32_t index) const;
+};
+
+}  // namespace komankondi::dict
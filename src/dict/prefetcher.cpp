@@ -0,0 +1,58 @@
+#include "prefetcher.hpp"
+
+#include <future>
+#include <optional>
+#include <string>
+
+#include "dict/reader.hpp"
+#include "dict/word.hpp"
+#include "utils/exception.hpp"
+#include "utils/log.hpp"
+#include "utils/scope_exit.hpp"
+
+namespace komankondi::dict {
+namespace {
+
+void prefetch(std::string&& path, ConsumeQueue<Word, QueueMode::spsc>& queue) {
+    ScopeExit queue_closer{[&] { queue.close(); }};
+
+    Reader dict{path};
+    while (queue.push(dict.pick_word())) {
+    }
+}
+
+}  // namespace
+
+
+Prefetcher::Prefetcher(std::string path, int depth) :
+        queue_{depth},
+        future_{std::async(std::launch::async, prefetch, std::move(path), std::ref(queue_))} {
+}
+
+Prefetcher::~Prefetcher() {
+    queue_.close();
+    log::debug("Prefetched words: {} hits, {} misses", stats_.hits, stats_.misses);
+}
+
+Word Prefetcher::pick_word() {
+    std::optional<Word> r = queue_.try_pop();
+    if (r) {
+        ++stats_.hits;
+        return std::move(*r);
+    }
+
+    ++stats_.misses;
+    r = queue_.pop();
+    if (!r) {
+        if (future_.valid())
+            future_.get();
+        throw Exception{"Could not pick word: prefetcher stopped"};
+    }
+    return std::move(*r);
+}
+
+Prefetcher::Stats Prefetcher::stats() const {
+    return stats_;
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <future>
+#include <string>
+
+#include "dict/word.hpp"
+#include "utils/consume_queue.hpp"
+
+namespace komankondi::dict {
+
+/// Picks random words from a dictionary in a background thread, so they are ready when needed.
+struct Prefetcher {
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+    };
+
+    Prefetcher(std::string path, int depth);
+    ~Prefetcher();
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+    Prefetcher(Prefetcher&&) noexcept = delete;
+    Prefetcher& operator=(Prefetcher&&) noexcept = delete;
+
+    Word pick_word();
+
+    Stats stats() const;
+
+private:
+    ConsumeQueue<Word, QueueMode::spsc> queue_;
+    std::future<void> future_;
+    Stats stats_;
+};
+
+}  // namespace komankondi::dict
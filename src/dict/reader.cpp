@@ -1,25 +1,138 @@
 #include "reader.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
 #include <random>
 #include <string>
+#include <string_view>
+#include <span>
 #include <tuple>
+#include <vector>
 
+#include <fmt/core.h>
+
+#include "dict/compression.hpp"
+#include "dict/full_text.hpp"
+#include "dict/native.hpp"
 #include "dict/word.hpp"
+#include "utils/database.hpp"
+#include "utils/exception.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dict {
+namespace {
+
+struct SqliteReader : Reader::Impl {
+    SqliteReader(ZStringView path) :
+            db_{path, true} {
+        int version = std::get<0>(db_.exec<std::tuple<int>>("PRAGMA user_version"));
+        // since version 2, words have contiguous rowids starting at 1
+        contiguous_ids_ = version >= 2;
+        // since version 3, descriptions are compressed
+        if (version >= 3) {
+            auto [dictionary] = db_.exec<std::tuple<std::vector<std::byte>>>("SELECT dictionary FROM compression");
+            decompress_.emplace(dictionary);
+        }
+        if (contiguous_ids_)
+            nr_words_ = std::get<0>(db_.exec<std::tuple<int>>("SELECT ifnull(max(rowid), 0) FROM word"));
+        else
+            nr_words_ = std::get<0>(db_.exec<std::tuple<int>>("SELECT COUNT() FROM word"));
+        full_text_ = std::get<0>(db_.exec<std::tuple<int>>("SELECT COUNT() FROM sqlite_master WHERE name='word_text'"));
+    }
+
+    int nr_words() override {
+        return nr_words_;
+    }
+
+    Word word(int index) override {
+        if (!op_word_) {
+            if (contiguous_ids_)
+                op_word_ = db_.prepare<std::tuple<std::string, std::vector<std::byte>>, int>("SELECT word, description FROM word WHERE rowid=?+1");
+            else
+                op_word_ = db_.prepare<std::tuple<std::string, std::vector<std::byte>>, int>("SELECT word, description FROM word WHERE rowid=(SELECT rowid FROM word LIMIT 1 OFFSET ?)");
+        }
+        auto [word, description] = op_word_.exec(index);
+        return {std::move(word), decode(description)};
+    }
+
+    std::optional<std::string> find_description(std::string_view word) override {
+        if (!op_find_description_)
+            op_find_description_ = db_.prepare<std::tuple<int, std::vector<std::byte>>, std::string_view>("SELECT COUNT(), max(description) FROM word WHERE word=?");
+        auto [found, description] = op_find_description_.exec(word);
+        if (!found)
+            return {};
+        return decode(description);
+    }
+
+    std::vector<Word> search(std::string_view query, int limit) override {
+        if (!full_text_)
+            throw Exception{"Could not search dictionary: it has no full-text index"};
+
+        // terms are quoted so that nothing the user typed is taken as query syntax
+        std::vector<std::string> terms = tokenize(query);
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+        std::vector<Word> r;
+        if (terms.empty() || limit <= 0)
+            return r;
+        std::string match;
+        for (const std::string& term : terms)
+            match += fmt::format("{}\"{}\"", match.empty() ? "" : " OR ", term);
+
+        if (!op_search_) {
+            op_search_ = db_.prepare<std::tuple<std::string, std::vector<std::byte>>, std::string_view, int>(
+                    "SELECT word.word, word.description FROM "
+                    "(SELECT rowid, rank FROM word_text WHERE word_text MATCH ? ORDER BY rank LIMIT ?) AS best "
+                    "JOIN word ON word.rowid=best.rowid ORDER BY best.rank");
+        }
+        op_search_.exec([&](std::string word, std::vector<std::byte> description) { r.push_back({std::move(word), decode(description)}); },
+                        match, limit);
+        return r;
+    }
+
+private:
+    Database db_;
+    Database::Operation<std::tuple<std::string, std::vector<std::byte>>, int> op_word_;
+    Database::Operation<std::tuple<int, std::vector<std::byte>>, std::string_view> op_find_description_;
+    Database::Operation<std::tuple<std::string, std::vector<std::byte>>, std::string_view, int> op_search_;
+    int nr_words_;
+    bool contiguous_ids_;
+    bool full_text_;
+    std::optional<DescriptionDecompressor> decompress_;
 
-Reader::Reader(ZStringView path) :
-        db_{path, true} {
-    nr_words_ = std::get<0>(db_.exec<std::tuple<int>>("SELECT COUNT() FROM word"));
+    std::string decode(std::span<const std::byte> description) {
+        if (decompress_)
+            return (*decompress_)(description);
+        return {reinterpret_cast<const char*>(description.data()), description.size()};
+    }
+};
+
+}  // namespace
+
+
+Reader::Reader(ZStringView path) {
+    if (is_native_dictionary(path))
+        impl_ = std::make_unique<NativeReader>(path);
+    else
+        impl_ = std::make_unique<SqliteReader>(path);
+    nr_words_ = impl_->nr_words();
 }
 
+Reader::~Reader() = default;
+
 Word Reader::pick_word() {
-    if (!op_pick_word_)
-        op_pick_word_ = db_.prepare<std::tuple<std::string, std::string>, int>("SELECT * FROM word WHERE rowid=(SELECT rowid FROM word LIMIT 1 OFFSET ?)");
-    std::random_device rng{};
-    int index = std::uniform_int_distribution{0, nr_words_ - 1}(rng);
-    return std::apply([](auto&&... a) { return Word{std::move(a)...}; }, op_pick_word_.exec(index));
+    int index = std::uniform_int_distribution{0, nr_words_ - 1}(rng_);
+    return impl_->word(index);
+}
+
+std::optional<std::string> Reader::find_description(std::string_view word) {
+    return impl_->find_description(word);
+}
+
+std::vector<Word> Reader::search(std::string_view query, int limit) {
+    return impl_->search(query, limit);
 }
 
 }  // namespace komankondi::dict
@@ -1,23 +1,45 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <random>
 #include <string>
-#include <tuple>
+#include <string_view>
+#include <vector>
 
 #include "dict/word.hpp"
-#include "utils/database.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dict {
 
+/// Reads dictionaries of any format.
 struct Reader {
+    struct Impl {
+        virtual ~Impl() = default;
+
+        virtual int nr_words() = 0;
+        virtual Word word(int index) = 0;
+        virtual std::optional<std::string> find_description(std::string_view word) = 0;
+        virtual std::vector<Word> search(std::string_view query, int limit) = 0;
+    };
+
     Reader(ZStringView path);
+    ~Reader();
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    Reader(Reader&&) noexcept = delete;
+    Reader& operator=(Reader&&) noexcept = delete;
 
     Word pick_word();
+    std::optional<std::string> find_description(std::string_view word);
+    /// At most limit words whose description has any term of query, the most relevant first as ranked by BM25.
+    /// Throws if the dictionary was generated without full-text index.
+    std::vector<Word> search(std::string_view query, int limit);
 
 private:
-    Database db_;
-    Database::Operation<std::tuple<std::string, std::string>, int> op_pick_word_;
+    std::unique_ptr<Impl> impl_;
     int nr_words_;
+    std::mt19937 rng_{std::random_device{}()};
 };
 
 }  // namespace komankondi::dict
@@ -2,29 +2,204 @@
 
 #include <cassert>
 #include <exception>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
+#include "dict/compression.hpp"
+#include "dict/native.hpp"
+#include "dict/near_words.hpp"
+#include "utils/exception.hpp"
+#include "utils/log.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dict {
 
-Writer::Writer(ZStringView path) :
-        db_{path, false} {
-    db_.exec("PRAGMA application_id=0x6b6d6b64;"
-             "PRAGMA user_version=1;"
-             "BEGIN;"
-             "DROP TABLE IF EXISTS word;"
-             "CREATE TABLE word(word TEXT PRIMARY KEY, description TEXT NOT NULL) STRICT");
+Writer::Writer(ZStringView path, Format format, bool full_text, bool near_words) :
+        path_{path},
+        tmp_path_{path_ + ".new"},
+        full_text_{full_text},
+        near_words_{near_words} {
+    std::filesystem::remove(tmp_path_);
+    if (format == Format::native) {
+        native_ = std::make_unique<NativeWriter>(tmp_path_, full_text);
+        return;
+    }
+
+    db_.emplace(tmp_path_, false);
+
+    // nothing to roll back to in a new file, and it is only synced once complete
+    db_->exec<std::tuple<std::string>>("PRAGMA journal_mode=OFF");
+    db_->exec("PRAGMA synchronous=OFF;"
+              "PRAGMA cache_size=-65536;"
+              "PRAGMA application_id=0x6b6d6b64;"
+              "PRAGMA user_version=3;"
+              "BEGIN;"
+              "CREATE TABLE word(word TEXT NOT NULL, description BLOB NOT NULL) STRICT;"
+              "CREATE TABLE compression(dictionary BLOB NOT NULL) STRICT");
+    // contentless, since descriptions are already stored compressed, and with the tokenizer the native format mimics
+    if (full_text_)
+        db_->exec("CREATE VIRTUAL TABLE word_text USING fts5(description, content='', tokenize='ascii')");
+}
+
+Writer::~Writer() {
+    if (!db_ && !native_)
+        return;
+    op_add_word_ = {};
+    op_add_batch_ = {};
+    op_add_text_ = {};
+    db_.reset();
+    native_.reset();
+    try {
+        std::filesystem::remove(tmp_path_);
+    }
+    catch (const std::exception& ex) {
+        log::warn("Could not clean incomplete dictionary file: {}", ex.what());
+    }
 }
 
 void Writer::add_word(std::string_view word, std::string_view description) {
-    if (!op_add_word_)
-        op_add_word_ = db_.prepare<void, std::string_view, std::string_view>("INSERT INTO word VALUES(?,?)");
-    op_add_word_.exec(word, description);
+    if (!add(word, description))
+        throw Exception{"Could not add word {}: already added", word};
+}
+
+int Writer::add_words(std::span<const Word> words) {
+    int r = 0;
+    for (const Word& word : words) {
+        if (add(word.word, word.description))
+            ++r;
+        else
+            log::debug("Could not add word {}: already added", word.word);
+    }
+    return r;
+}
+
+bool Writer::add(std::string_view word, std::string_view description) {
+    if (!words_.emplace(word).second)
+        return false;
+
+    if (compressor_) {
+        store(word, description, (*compressor_)(description));
+        return true;
+    }
+    training_words_.push_back({std::string{word}, std::string{description}});
+    training_words_size_ += description.size();
+    if (training_words_size_ >= training_size)
+        train();
+    return true;
+}
+
+void Writer::train() {
+    std::vector<std::string> samples;
+    samples.reserve(training_words_.size());
+    for (const Word& word : training_words_)
+        samples.push_back(word.description);
+    compressor_ = std::make_unique<DescriptionCompressor>(samples);
+
+    if (db_)
+        db_->exec<void, std::span<const std::byte>>("INSERT INTO compression VALUES(?)", compressor_->dictionary());
+
+    for (const Word& word : training_words_)
+        store(word.word, word.description, (*compressor_)(word.description));
+    training_words_ = {};
+}
+
+void Writer::store(std::string_view word, std::string_view description, std::vector<std::byte>&& compressed) {
+    if (native_) {
+        native_->add_word(word, compressed, description);
+        return;
+    }
+
+    // words get rowids in the order they are stored, whether inserted in batches or not
+    ++nr_stored_;
+    if (full_text_) {
+        if (!op_add_text_)
+            op_add_text_ = db_->prepare<void, int, std::string_view>("INSERT INTO word_text(rowid, description) VALUES(?,?)");
+        op_add_text_.exec(nr_stored_, description);
+    }
+
+    batch_.emplace_back(word, std::move(compressed));
+    if (std::ssize(batch_) == batch_size)
+        flush_batch();
+}
+
+void Writer::flush_batch() {
+    std::vector<std::tuple<std::string_view, std::span<const std::byte>>> rows;
+    rows.reserve(batch_.size());
+    for (const auto& [word, description] : batch_)
+        rows.emplace_back(word, description);
+
+    if (std::ssize(rows) == batch_size) {
+        if (!op_add_batch_) {
+            std::string query = "INSERT INTO word VALUES(?,?)";
+            for (int i = 1; i < batch_size; ++i)
+                query += ",(?,?)";
+            op_add_batch_ = db_->prepare<void, std::string_view, std::span<const std::byte>>(query);
+        }
+        op_add_batch_.exec_rows(std::span{rows});
+    }
+    else {
+        if (!op_add_word_)
+            op_add_word_ = db_->prepare<void, std::string_view, std::span<const std::byte>>("INSERT INTO word VALUES(?,?)");
+        for (const auto& [word, description] : rows)
+            op_add_word_.exec(word, description);
+    }
+    batch_.clear();
 }
 
 void Writer::save() {
-    db_.exec("COMMIT");
+    if (!compressor_)
+        train();
+
+    if (native_) {
+        native_->save(compressor_->dictionary());
+        native_.reset();
+        replace_files();
+        return;
+    }
+
+    assert(db_);
+    flush_batch();
+
+    // readers rely on rowids being exactly 1 to the number of words to pick one in constant time
+    auto [nr_words, max_id] = db_->exec<std::tuple<int, int>>("SELECT COUNT(), ifnull(max(rowid), 0) FROM word");
+    if (nr_words != max_id)
+        throw Exception{"Could not save dictionary: {} words but ids go up to {}", nr_words, max_id};
+
+    // the file is read-only from now on, so the index is merged into a single b-tree for the fastest queries
+    if (full_text_)
+        db_->exec("INSERT INTO word_text(word_text) VALUES('optimize')");
+
+    // building the index once is much faster than keeping it sorted through all inserts,
+    // and syncing the transaction creating it also syncs the words written before
+    db_->exec("COMMIT;"
+              "PRAGMA synchronous=FULL;"
+              "CREATE UNIQUE INDEX word_word ON word(word)");
+
+    op_add_word_ = {};
+    op_add_batch_ = {};
+    op_add_text_ = {};
+    db_.reset();
+    replace_files();
+}
+
+void Writer::replace_files() {
+    std::string near_path = near_words_path(path_);
+    std::string near_tmp_path = near_path + ".new";
+    if (near_words_)
+        write_near_words(near_tmp_path, {words_.begin(), words_.end()});
+
+    std::filesystem::rename(tmp_path_, path_);
+    // an index of the previous words would no longer match
+    if (near_words_)
+        std::filesystem::rename(near_tmp_path, near_path);
+    else
+        std::filesystem::remove(near_path);
 }
 
 }  // namespace komankondi::dict
@@ -1,21 +1,72 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "dict/format.hpp"
+#include "dict/word.hpp"
 #include "utils/database.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dict {
 
+struct DescriptionCompressor;
+struct NativeWriter;
+
+/// Bulk-loads a new dictionary into a temporary file, that replaces the one at path when saved.
+/// Descriptions are compressed with a dictionary trained on the first ones, that are held back until then.
+/// With full_text, their terms are also indexed so that Reader::search finds words by their descriptions,
+/// and with near_words, words are also written sorted next to the dictionary for NearWords.
 struct Writer {
-    Writer(ZStringView path);
+    /// Number of words inserted by each statement.
+    static constexpr int batch_size = 64;
+    /// Size of descriptions to train the compression dictionary on.
+    static constexpr size_t training_size = 8 << 20;
+
+    Writer(ZStringView path, Format format = Format::sqlite, bool full_text = false, bool near_words = false);
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer(Writer&&) noexcept = delete;
+    Writer& operator=(Writer&&) noexcept = delete;
 
+    /// Throws if the word was already added.
     void add_word(std::string_view word, std::string_view description);
+    /// Skips words that were already added, and returns how many were not.
+    int add_words(std::span<const Word> words);
     void save();
 
 private:
-    Database db_;
-    Database::Operation<void, std::string_view, std::string_view> op_add_word_;
+    std::string path_;
+    std::string tmp_path_;
+    std::optional<Database> db_;
+    Database::Operation<void, std::string_view, std::span<const std::byte>> op_add_word_;
+    Database::Operation<void, std::string_view, std::span<const std::byte>> op_add_batch_;
+    Database::Operation<void, int, std::string_view> op_add_text_;
+    std::unique_ptr<NativeWriter> native_;
+    bool full_text_;
+    bool near_words_;
+    int nr_stored_ = 0;
+
+    std::unordered_set<std::string> words_;
+    std::vector<Word> training_words_;
+    size_t training_words_size_ = 0;
+    std::unique_ptr<DescriptionCompressor> compressor_;
+    std::vector<std::pair<std::string, std::vector<std::byte>>> batch_;
+
+    bool add(std::string_view word, std::string_view description);
+    void train();
+    void store(std::string_view word, std::string_view description, std::vector<std::byte>&& compressed);
+    void flush_batch();
+    void replace_files();
 };
 
 }  // namespace komankondi::dict
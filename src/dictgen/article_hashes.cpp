@@ -0,0 +1,124 @@
+#include "article_hashes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/exception.hpp"
+#include "utils/file.hpp"
+#include "utils/hasher.hpp"
+#include "utils/log.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+// file layout: magic, spec hash, number of articles, then their records
+constexpr std::array<char, 8> article_hashes_magic = {'K', 'M', 'K', 'H', 'A', 'S', 'H', '1'};
+
+struct ArticleHashRecord {
+    uint64_t name;
+    uint64_t content;
+    uint8_t has_word;
+    std::array<uint8_t, 7> padding{};
+};
+static_assert(sizeof(ArticleHashRecord) == 24);
+
+}  // namespace
+
+
+std::optional<ArticleHashes> ArticleHashes::load(ZStringView path, std::string_view spec_hash) {
+    // without them all articles get extracted again, that is slower but not wrong
+    try {
+        if (!std::filesystem::exists(path.data()))
+            return {};
+
+        size_t header_size = article_hashes_magic.size() + spec_hash.size() + sizeof(uint64_t);
+        uint64_t file_size = std::filesystem::file_size(path.data());
+        File file{path, File::Mode::read | File::Mode::binary};
+        std::vector<char> header = file.read<char>(static_cast<int>(header_size));
+        if (header.size() < header_size || !std::equal(article_hashes_magic.begin(), article_hashes_magic.end(), header.begin()))
+            throw Exception{"invalid header"};
+        if (!std::equal(spec_hash.begin(), spec_hash.end(), header.begin() + article_hashes_magic.size())) {
+            log::debug("Article hashes {} are for another language spec", path);
+            return {};
+        }
+        uint64_t nr_articles;
+        std::memcpy(&nr_articles, header.data() + article_hashes_magic.size() + spec_hash.size(), sizeof(nr_articles));
+        if (nr_articles != (file_size - header_size) / sizeof(ArticleHashRecord) || (file_size - header_size) % sizeof(ArticleHashRecord) != 0)
+            throw Exception{"file size {} does not match {} articles", file_size, nr_articles};
+
+        std::vector<ArticleHashRecord> records = file.read<ArticleHashRecord>(static_cast<int>(nr_articles));
+        if (records.size() != nr_articles)
+            throw Exception{"{} articles instead of {}", records.size(), nr_articles};
+
+        ArticleHashes r;
+        r.hashes_.reserve(records.size());
+        for (const ArticleHashRecord& record : records)
+            r.hashes_.push_back({record.name, record.content, record.has_word != 0});
+        if (!std::is_sorted(r.hashes_.begin(), r.hashes_.end(), [](const ArticleHash& a, const ArticleHash& b) { return a.name < b.name; }))
+            throw Exception{"not sorted"};
+        return r;
+    }
+    catch (const std::exception& ex) {
+        log::warn("Could not load article hashes {}, extracting all articles again: {}", path, ex.what());
+    }
+    return {};
+}
+
+void ArticleHashes::save(ZStringView path, std::string_view spec_hash) {
+    std::ranges::sort(hashes_, {}, &ArticleHash::name);
+
+    std::vector<ArticleHashRecord> records;
+    records.reserve(hashes_.size());
+    for (const ArticleHash& hash : hashes_)
+        records.push_back({hash.name, hash.content, hash.has_word});
+
+    std::string tmp_path = path.data();
+    tmp_path += ".new";
+    {
+        File file{tmp_path, File::Mode::truncate | File::Mode::binary};
+        file.write<char>(article_hashes_magic);
+        file.write(std::span{spec_hash});
+        uint64_t nr_articles = records.size();
+        file.write<uint64_t>(std::span{&nr_articles, 1});
+        file.write<ArticleHashRecord>(records);
+        file.sync();
+    }
+    std::filesystem::rename(tmp_path, path.data());
+}
+
+void ArticleHashes::add(const ArticleHash& hash) {
+    hashes_.push_back(hash);
+}
+
+const ArticleHash* ArticleHashes::find(uint64_t name) const {
+    auto it = std::ranges::lower_bound(hashes_, name, {}, &ArticleHash::name);
+    if (it == hashes_.end() || it->name != name)
+        return nullptr;
+    return &*it;
+}
+
+int ArticleHashes::size() const {
+    return static_cast<int>(hashes_.size());
+}
+
+
+uint64_t hash64(Hasher& hasher, std::string_view data) {
+    hasher.reset();
+    hasher.update(std::as_bytes(std::span{data}));
+    std::vector<std::byte> digest = hasher.finish();
+    uint64_t r;
+    std::memcpy(&r, digest.data(), sizeof(r));
+    return r;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "utils/hasher.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+
+struct ArticleHash {
+    uint64_t name = 0;
+    uint64_t content = 0;
+    bool has_word = false;  ///< whether the article gave a word in the dictionary
+};
+
+/// Hashes of the articles a dictionary got generated from, so that the next generation only extracts again
+/// the articles that changed, and takes the description of the others from the previous dictionary.
+struct ArticleHashes {
+    ArticleHashes() = default;
+
+    /// Nothing if there is no file, if it was saved for another spec hash, or if it cannot be read.
+    static std::optional<ArticleHashes> load(ZStringView path, std::string_view spec_hash);
+    void save(ZStringView path, std::string_view spec_hash);
+
+    void add(const ArticleHash& hash);
+    const ArticleHash* find(uint64_t name) const;
+
+    int size() const;
+
+private:
+    std::vector<ArticleHash> hashes_;  ///< sorted by name once loaded or saved
+};
+
+/// First 8 bytes of the digest of data, with a hasher that can be reused.
+uint64_t hash64(Hasher& hasher, std::string_view data);
+
+}  // namespace komankondi::dictgen
@@ -1,8 +1,12 @@
 #include "dictgen/cache.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <fmt/core.h>
@@ -17,18 +21,22 @@ Cacher::Cacher(std::string path) :
         path_{std::move(path)} {
     tmp_path_ = path_;
     tmp_path_ += ".new";
+    validator_path_ = tmp_path_;
+    validator_path_ += ".validator";
     log::debug("Saving temporary cache to {}", tmp_path_);
 
-    auto lock = [&] {
-        tmp_lock_ = {tmp_path_.c_str()};
-        if (!tmp_lock_.try_lock())
-            throw Exception{"Could not gain exclusive access to the temporary cache file"};
-    };
-
     if (std::filesystem::exists(tmp_path_)) {
         log::debug("Temporary cache file already exists");
         lock();
-        tmp_file_ = {tmp_path_, File::Mode::truncate | File::Mode::binary};
+        tmp_file_ = {tmp_path_, File::Mode::append | File::Mode::binary};
+
+        // data written without knowing the version of the file cannot be resumed
+        if (std::filesystem::exists(validator_path_)) {
+            std::vector<char> validator = File{validator_path_, File::Mode::read | File::Mode::binary}.read<char>();
+            kept_validator_.assign(validator.begin(), validator.end());
+            if (!kept_validator_.empty())
+                kept_size_ = std::filesystem::file_size(tmp_path_);
+        }
     }
     else {
         std::filesystem::create_directories(std::filesystem::path{path_}.parent_path());
@@ -37,22 +45,50 @@ Cacher::Cacher(std::string path) :
     }
 }
 
-Cacher::~Cacher() {
-    if (!tmp_file_)
-        return;
-    tmp_lock_ = {};
-    tmp_file_ = {};
-    try {
-        std::filesystem::remove(tmp_path_);
+File Cacher::read_kept() const {
+    return {tmp_path_, File::Mode::read | File::Mode::binary};
+}
+
+void Cacher::begin(int64_t offset, std::string_view validator) {
+    if (offset > kept_size_)
+        throw Exception{"Could not resume cache at {}: only {} bytes kept", offset, kept_size_};
+    if (offset > 0)
+        log::info("Resuming download after {} cached bytes", offset);
+
+    if (offset < static_cast<int64_t>(std::filesystem::file_size(tmp_path_))) {
+        // closing any descriptor of the file releases its lock
+        tmp_file_ = {};
+        std::filesystem::resize_file(tmp_path_, offset);
+        tmp_file_ = {tmp_path_, File::Mode::append | File::Mode::binary};
+        lock();
     }
-    catch (const std::exception& ex) {
-        log::warn("Could not clean incomplete cache file: {}", ex.what());
+
+    // the data kept from now on belongs to the new version
+    if (validator.empty()) {
+        std::filesystem::remove(validator_path_);
+    }
+    else {
+        File validator_file{validator_path_, File::Mode::truncate | File::Mode::binary};
+        validator_file.write(std::span{validator});
+        validator_file.sync();
     }
+    kept_size_ = offset;
+    kept_validator_ = validator;
+}
+
+void Cacher::lock() {
+    tmp_lock_ = {tmp_path_.c_str()};
+    if (!tmp_lock_.try_lock())
+        throw Exception{"Could not gain exclusive access to the temporary cache file"};
 }
 
 void Cacher::save() {
+    // already saved
+    if (!tmp_file_)
+        return;
     tmp_file_.sync();
     std::filesystem::rename(tmp_path_, path_);
+    std::filesystem::remove(validator_path_);
     tmp_lock_ = {};
     tmp_file_ = {};
     log::info("Successfully saved cache");
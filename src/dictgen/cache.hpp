@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
+#include <string>
+#include <string_view>
 
 #include <boost/interprocess/sync/file_lock.hpp>
 
@@ -10,15 +13,31 @@
 
 namespace komankondi::dictgen {
 
+/// Writes a download to a temporary cache file, renamed into place once complete.
+/// The temporary file is kept when interrupted, so that the next run can resume the download.
 struct Cacher {
     Cacher() = default;
     Cacher(std::string path);
-    ~Cacher();
     Cacher(const Cacher&) = delete;
     Cacher& operator=(const Cacher&) = delete;
     Cacher(Cacher&&) noexcept = default;
     Cacher& operator=(Cacher&&) noexcept = default;
 
+    /// Size of the data kept from a previous run, 0 if it cannot be resumed.
+    int64_t kept_size() const {
+        return kept_size_;
+    }
+    /// ETag or Last-Modified of the version of the file the kept data belongs to.
+    const std::string& kept_validator() const {
+        return kept_validator_;
+    }
+
+    File read_kept() const;
+
+    /// Start writing after the first offset bytes of kept data, for the version of the file identified by validator.
+    void begin(int64_t offset, std::string_view validator);
+
+    /// Does nothing once saved.
     void save();
 
     template <typename T>
@@ -29,8 +48,13 @@ struct Cacher {
 private:
     std::string path_;
     std::string tmp_path_;
+    std::string validator_path_;
+    int64_t kept_size_ = 0;
+    std::string kept_validator_;
     File tmp_file_;
     boost::interprocess::file_lock tmp_lock_;
+
+    void lock();
 };
 
 
@@ -1,50 +1,317 @@
 #include "dictgen/downloader.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <future>
+#include <map>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include <fmt/core.h>
 #include <httplib.h>
-#include <range/v3/range/conversion.hpp>
 
 #include "utils/exception.hpp"
+#include "utils/guarded.hpp"
+#include "utils/log.hpp"
 #include "utils/scope_exit.hpp"
 
 namespace komankondi::dictgen {
 namespace {
 
-void download(std::string&& host, std::string&& url, ConsumeQueue<std::vector<std::byte>>& queue) {
-    ScopeExit queue_closer{[&] { queue.close(); }};
+using DownloadQueue = ConsumeQueue<BufferPool::Buffer, QueueMode::spsc>;
 
-    httplib::Result res = httplib::SSLClient{host}.Get(
-            url,
+/// Strong ETag, or else Last-Modified: weak ETags cannot be used in If-Range.
+std::string find_validator(const httplib::Response& res) {
+    if (std::string etag = res.get_header_value("ETag"); !etag.empty() && !etag.starts_with("W/"))
+        return etag;
+    return res.get_header_value("Last-Modified");
+}
+
+std::optional<int64_t> parse_int(std::string_view& text) {
+    int64_t r = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), r);
+    if (ec != std::errc{})
+        return {};
+    text.remove_prefix(end - text.data());
+    return r;
+}
+
+/// First position of a "bytes first-last/size" Content-Range.
+std::optional<int64_t> parse_content_range(std::string_view range) {
+    constexpr std::string_view prefix = "bytes ";
+    if (!range.starts_with(prefix))
+        return {};
+    range.remove_prefix(prefix.size());
+    std::optional<int64_t> r = parse_int(range);
+    if (!range.starts_with('-'))
+        return {};
+    return r;
+}
+
+BufferPool::Buffer make_buffer(BufferPool& pool, const char* ptr, size_t size) {
+    std::span<const std::byte> data = std::as_bytes(std::span{ptr, size});
+    BufferPool::Buffer r = pool.get(data.size());
+    r->assign(data.begin(), data.end());
+    return r;
+}
+
+void download(const std::string& origin, const std::string& url, BufferPool& pool, int64_t offset, const std::string& validator,
+              std::promise<Downloader::Headers>& headers, DownloadQueue& queue) {
+    httplib::Headers request_headers;
+    if (offset > 0 && !validator.empty()) {
+        // If-Range makes the server send the whole file instead if it changed since
+        request_headers.emplace("Range", fmt::format("bytes={}-", offset));
+        request_headers.emplace("If-Range", validator);
+    }
+
+    bool skip_body = false;
+    httplib::Result res = httplib::Client{origin}.Get(
+            url, request_headers,
             [&](const httplib::Response& res) {
-                if (res.status != 200)
+                Downloader::Headers r{.validator = find_validator(res)};
+                if (res.status == 206) {
+                    std::optional<int64_t> first = parse_content_range(res.get_header_value("Content-Range"));
+                    if (first != offset)
+                        throw Exception{"Could not resume download: unexpected range {}", res.get_header_value("Content-Range")};
+                    r.offset = offset;
+                    if (r.validator.empty())
+                        r.validator = validator;
+                }
+                else if (res.status == 416 && request_headers.contains("Range")) {
+                    // the range only gets checked once the validator matched: everything was already downloaded
+                    r = {offset, validator};
+                    skip_body = true;
+                }
+                else if (res.status != 200) {
                     throw Exception{"Could not download file: HTTP status {} ({})", res.status, res.reason};
+                }
+                headers.set_value(std::move(r));
                 return true;
             },
             [&](const char* ptr, size_t size) {
-                return queue.push(std::as_bytes(std::span{ptr, size}) | ranges::to<std::vector>);
+                return skip_body || queue.push(make_buffer(pool, ptr, size));
             });
 
     if (!res)
         throw Exception{"Could not download file: {}", httplib::to_string(res.error())};
 }
 
+
+struct SegmentedDownload {
+    SegmentedDownload(std::string origin, std::string url, BufferPool& pool, std::string validator, int64_t begin, int64_t end, int nr_connections) :
+            origin_{std::move(origin)},
+            url_{std::move(url)},
+            pool_{pool},
+            validator_{std::move(validator)},
+            begin_{begin},
+            end_{end},
+            nr_connections_{nr_connections} {
+    }
+
+    /// Download and push segments in order to the queue.
+    void operator()(DownloadQueue& queue) {
+        int nr_segments = static_cast<int>((end_ - begin_ + Downloader::segment_size - 1) / Downloader::segment_size);
+        int window = 2 * nr_connections_;
+
+        std::vector<std::future<void>> workers;
+        ScopeExit workers_stopper{[&] {
+            abort();
+            for (std::future<void>& worker : workers) {
+                if (worker.valid())
+                    worker.wait();
+            }
+        }};
+        for (int i = 0; i < std::min(nr_connections_, nr_segments); ++i)
+            workers.push_back(std::async(std::launch::async, [&] { work(nr_segments, window); }));
+
+        for (int i = 0; i < nr_segments; ++i) {
+            std::vector<BufferPool::Buffer> segment;
+            {
+                GuardedHandle<Shared> s = shared_.lock();
+                s.wait(condvar_, [&] { return s->aborted || s->done.contains(i); });
+                if (s->aborted)
+                    break;
+                segment = std::move(s->done.extract(i).mapped());
+                s->next_to_push = i + 1;
+            }
+            condvar_.notify_all();
+
+            for (BufferPool::Buffer& buffer : segment) {
+                if (!queue.push(std::move(buffer))) {
+                    abort();
+                    break;
+                }
+            }
+        }
+
+        abort();
+        for (std::future<void>& worker : workers)
+            worker.get();
+    }
+
+private:
+    std::string origin_;
+    std::string url_;
+    BufferPool& pool_;
+    std::string validator_;
+    int64_t begin_;
+    int64_t end_;
+    int nr_connections_;
+
+    struct Shared {
+        bool aborted = false;
+        int next_to_start = 0;
+        int next_to_push = 0;
+        std::map<int, std::vector<BufferPool::Buffer>> done;
+    };
+    Guarded<Shared> shared_;
+    std::condition_variable condvar_;
+    std::atomic<bool> aborted_ = false;
+
+    void abort() {
+        shared_.lock()->aborted = true;
+        aborted_ = true;
+        condvar_.notify_all();
+    }
+
+    void work(int nr_segments, int window) {
+        try {
+            httplib::Client client{origin_};
+            client.set_keep_alive(true);
+            while (true) {
+                int i;
+                {
+                    GuardedHandle<Shared> s = shared_.lock();
+                    s.wait(condvar_, [&] { return s->aborted || s->next_to_start < s->next_to_push + window; });
+                    if (s->aborted || s->next_to_start == nr_segments)
+                        return;
+                    i = s->next_to_start++;
+                }
+
+                std::vector<BufferPool::Buffer> segment = download_segment(client, i);
+                shared_.lock()->done.emplace(i, std::move(segment));
+                condvar_.notify_all();
+            }
+        }
+        catch (...) {
+            abort();
+            throw;
+        }
+    }
+
+    std::vector<BufferPool::Buffer> download_segment(httplib::Client& client, int index) {
+        int64_t first = begin_ + index * Downloader::segment_size;
+        int64_t last = std::min(first + Downloader::segment_size, end_) - 1;
+        httplib::Headers request_headers{
+                {"Range", fmt::format("bytes={}-{}", first, last)},
+                {"If-Range", validator_},
+        };
+
+        std::vector<BufferPool::Buffer> r;
+        int64_t size = 0;
+        httplib::Result res = client.Get(
+                url_, request_headers,
+                [&](const httplib::Response& res) {
+                    if (res.status == 200)
+                        throw Exception{"Could not download file: it changed during the download"};
+                    if (res.status != 206)
+                        throw Exception{"Could not download file: HTTP status {} ({})", res.status, res.reason};
+                    if (parse_content_range(res.get_header_value("Content-Range")) != first)
+                        throw Exception{"Could not download file: unexpected range {}", res.get_header_value("Content-Range")};
+                    return true;
+                },
+                [&](const char* ptr, size_t size_read) {
+                    size += size_read;
+                    r.push_back(make_buffer(pool_, ptr, size_read));
+                    return !aborted_;
+                });
+
+        if (!res) {
+            if (aborted_)
+                return {};
+            throw Exception{"Could not download file: {}", httplib::to_string(res.error())};
+        }
+        if (size != last + 1 - first)
+            throw Exception{"Could not download file: got {} bytes for range {}-{}", size, first, last};
+        return r;
+    }
+};
+
+/// Start a segmented download if the server supports it, or fall back to a single connection.
+/// Its errors before setting headers, like a failed HEAD request, are given to them by the task of the Downloader.
+void download_parallel(const std::string& origin, const std::string& url, BufferPool& pool, int64_t offset, const std::string& validator,
+                       int nr_connections, std::promise<Downloader::Headers>& headers, DownloadQueue& queue) {
+    httplib::Result res = httplib::Client{origin}.Head(url);
+    if (!res)
+        throw Exception{"Could not download file: {}", httplib::to_string(res.error())};
+    if (res->status != 200)
+        throw Exception{"Could not download file: HTTP status {} ({})", res->status, res->reason};
+
+    std::string current_validator = find_validator(*res);
+    std::string length_header = res->get_header_value("Content-Length");
+    std::string_view length_view = length_header;
+    std::optional<int64_t> length = parse_int(length_view);
+    if (current_validator.empty() || !length || res->get_header_value("Accept-Ranges") != "bytes") {
+        log::debug("Server does not support concurrent ranges, downloading with a single connection");
+        download(origin, url, pool, offset, validator, headers, queue);
+        return;
+    }
+
+    if (validator != current_validator || offset > *length)
+        offset = 0;
+    headers.set_value({offset, current_validator});
+
+    SegmentedDownload{origin, url, pool, current_validator, offset, *length, nr_connections}(queue);
+}
+
 }  // namespace
 
 
-Downloader::Downloader(std::string host, std::string url) :
-        future_{std::async(std::launch::async, download, std::move(host), std::move(url), std::ref(queue_))} {
+Downloader::Downloader(std::string origin, std::string url, BufferPool& pool, int64_t offset, std::string validator, int nr_connections) {
+    std::promise<Headers> headers;
+    headers_ = headers.get_future();
+    future_ = std::async(std::launch::async, [=, this, &pool, headers = std::move(headers)]() mutable {
+        ScopeExit queue_closer{[&] { queue_.close(); }};
+        try {
+            if (nr_connections > 1)
+                download_parallel(origin, url, pool, offset, validator, nr_connections, headers, queue_);
+            else
+                download(origin, url, pool, offset, validator, headers, queue_);
+        }
+        catch (...) {
+            // the promise lives as long as the future of this task, it would never be broken
+            try {
+                headers.set_exception(std::current_exception());
+            }
+            catch (const std::future_error&) {
+                // the headers were already received
+            }
+            throw;
+        }
+    });
 }
 
 Downloader::~Downloader() {
     queue_.close();
 }
 
-std::optional<std::vector<std::byte>> Downloader::read() {
-    std::optional<std::vector<std::byte>> r = queue_.pop();
+const Downloader::Headers& Downloader::headers() {
+    // throws the error of the download if it failed before getting them
+    if (!headers_value_)
+        headers_value_ = headers_.get();
+    return *headers_value_;
+}
+
+std::optional<BufferPool::Buffer> Downloader::read() {
+    std::optional<BufferPool::Buffer> r = queue_.pop();
     if (!r && future_.valid())
         future_.get();
     return r;
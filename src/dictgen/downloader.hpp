@@ -1,26 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <future>
 #include <optional>
 #include <string>
-#include <vector>
 
+#include "utils/buffer_pool.hpp"
 #include "utils/consume_queue.hpp"
 
 namespace komankondi::dictgen {
 
 struct Downloader {
-    Downloader(std::string host, std::string url);
+    struct Headers {
+        int64_t offset = 0;     ///< position in the file of the first downloaded byte
+        std::string validator;  ///< ETag or Last-Modified identifying the version of the file, empty if there is none usable
+    };
+
+    /// Consecutive parts of the file downloaded by each connection, when using several.
+    static constexpr int64_t segment_size = 4 << 20;
+
+    /// Download the file at url from origin (scheme://host[:port]), starting at offset if the server
+    /// still serves the version identified by validator, or from the beginning otherwise.
+    /// With several connections, segments are downloaded concurrently and reassembled in order,
+    /// keeping at most two segments per connection in memory.
+    Downloader(std::string origin, std::string url, BufferPool& pool, int64_t offset = 0, std::string validator = {},
+               int nr_connections = 1);
     ~Downloader();
     Downloader(const Downloader&) = delete;
     Downloader& operator=(const Downloader&) = delete;
     Downloader(Downloader&&) noexcept = delete;
     Downloader& operator=(Downloader&&) noexcept = delete;
 
-    std::optional<std::vector<std::byte>> read();
+    /// Wait for the response headers.
+    const Headers& headers();
+
+    std::optional<BufferPool::Buffer> read();
 
 private:
-    ConsumeQueue<std::vector<std::byte>> queue_;
+    ConsumeQueue<BufferPool::Buffer, QueueMode::spsc> queue_;
+    std::future<Headers> headers_;
+    std::optional<Headers> headers_value_;
     std::future<void> future_;
 };
 
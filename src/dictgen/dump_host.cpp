@@ -0,0 +1,67 @@
+#include "dump_host.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <httplib.h>
+
+#include "dictgen/wiktionary.hpp"
+#include "utils/exception.hpp"
+
+namespace komankondi::dictgen {
+
+DumpHost::DumpHost(std::vector<HostedDump> dumps) :
+        dumps_{std::move(dumps)},
+        server_{std::make_unique<httplib::Server>()} {
+    // same index page layout as the real one, a link per run
+    std::set<std::string> dates;
+    for (const HostedDump& dump : dumps_)
+        dates.insert(dump.date);
+    std::string index = "<html><body><h1>Index of /other/enterprise_html/runs/</h1><hr><pre><a href=\"../\">../</a>\n";
+    for (const std::string& date : dates)
+        index += fmt::format("<a href=\"{}/\">{}/</a>\n", date, date);
+    index += "</pre><hr></body></html>";
+
+    server_->Get(std::string{dump_runs_path}, [index](const httplib::Request&, httplib::Response& res) {
+        res.set_content(index, "text/html");
+    });
+    server_->Get(fmt::format("{}.*", dump_runs_path), [this](const httplib::Request& req, httplib::Response& res) {
+        auto it = std::find_if(dumps_.begin(), dumps_.end(), [&](const HostedDump& dump) { return dump_path(dump.code, dump.date) == req.path; });
+        if (it == dumps_.end()) {
+            res.status = 404;
+            return;
+        }
+
+        // lets downloads resume and use several connections
+        res.set_header("ETag", fmt::format("\"{}-{}-{}\"", it->code, it->date, it->archive.size()));
+        res.set_header("Accept-Ranges", "bytes");
+        const std::vector<std::byte>& archive = it->archive;
+        res.set_content_provider(archive.size(), "application/octet-stream",
+                                 [&archive](size_t offset, size_t length, httplib::DataSink& sink) {
+                                     return sink.write(reinterpret_cast<const char*>(archive.data()) + offset, length);
+                                 });
+    });
+
+    int port = server_->bind_to_any_port("127.0.0.1");
+    if (port < 0)
+        throw Exception{"Could not bind dump host to a port"};
+    origin_ = fmt::format("http://127.0.0.1:{}", port);
+    thread_ = std::thread{[this] { server_->listen_after_bind(); }};
+    server_->wait_until_ready();
+}
+
+DumpHost::~DumpHost() {
+    server_->stop();
+    thread_.join();
+}
+
+const std::string& DumpHost::origin() const {
+    return origin_;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace httplib {
+class Server;
+}
+
+namespace komankondi::dictgen {
+
+/// Dump served by a DumpHost.
+struct HostedDump {
+    std::string code;  ///< of the language of the Wiktionary
+    std::string date;  ///< of the run, YYYYMMDD
+    std::vector<std::byte> archive;
+};
+
+/// HTTP server on localhost standing in for dumps.wikimedia.org, serving the runs index and dumps from memory,
+/// in a thread of its own until destroyed.
+struct DumpHost {
+    explicit DumpHost(std::vector<HostedDump> dumps);
+    ~DumpHost();
+    DumpHost(const DumpHost&) = delete;
+    DumpHost& operator=(const DumpHost&) = delete;
+    DumpHost(DumpHost&&) noexcept = delete;
+    DumpHost& operator=(DumpHost&&) noexcept = delete;
+
+    /// To give as dump host to generate_dictionary.
+    const std::string& origin() const;
+
+private:
+    std::vector<HostedDump> dumps_;
+    std::unique_ptr<httplib::Server> server_;
+    std::string origin_;
+    std::thread thread_;
+};
+
+}  // namespace komankondi::dictgen
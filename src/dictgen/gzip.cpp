@@ -1,26 +1,98 @@
 #include "gzip.hpp"
 
+#include <memory>
 #include <span>
+#include <string_view>
 #include <vector>
 
 #include <zlib.h>
 
-#include "utils/config.hpp"
+#include "dictgen/gzip_backends.hpp"
+#include "dictgen/parallel_gzip.hpp"
 #include "utils/exception.hpp"
-#include "utils/log.hpp"
 
 namespace komankondi::dictgen {
+namespace {
 
-GzipDecompressor::~GzipDecompressor() {
-    if (!running_)
-        return;
+struct ZlibApi {
+    using Stream = z_stream;
 
-    if (int err = inflateEnd(&stream_); err)
-        log::error("Could not cleanup gzip decompressor stream, error {}", err);
+    static constexpr int stream_end = Z_STREAM_END;
+
+    static int init(Stream* stream) {
+        return inflateInit2(stream, 15 + 16);  // max window size + 16 for gzip mode
+    }
+    static int inflate(Stream* stream) {
+        return ::inflate(stream, Z_NO_FLUSH);
+    }
+    static int end(Stream* stream) {
+        return inflateEnd(stream);
+    }
+};
+
+
+struct ParallelDecompressor : GzipDecompressor::Impl {
+    bool finished() const override {
+        return impl_.finished();
+    }
+
+    void decompress(std::span<const std::byte> data, std::vector<std::byte>& out) override {
+        impl_(data, out);
+    }
+
+private:
+    ParallelGzipDecompressor impl_;
+};
+
+}  // namespace
+
+
+std::vector<GzipBackend> gzip_backends() {
+    std::vector<GzipBackend> r{GzipBackend::zlib};
+#ifdef WITH_ZLIB_NG
+    r.push_back(GzipBackend::zlib_ng);
+#endif
+#ifdef WITH_LIBDEFLATE
+    r.push_back(GzipBackend::libdeflate);
+#endif
+    r.push_back(GzipBackend::parallel);
+    return r;
+}
+
+std::string_view format_as(GzipBackend backend) {
+    switch (backend) {
+    case GzipBackend::zlib: return "zlib";
+    case GzipBackend::zlib_ng: return "zlib-ng";
+    case GzipBackend::libdeflate: return "libdeflate";
+    case GzipBackend::parallel: return "parallel";
+    }
+    throw Exception{"Could not format unknown gzip backend {}", static_cast<int>(backend)};
 }
 
+
+GzipDecompressor::GzipDecompressor(GzipBackend backend) {
+    switch (backend) {
+    case GzipBackend::zlib:
+        impl_ = std::make_unique<StreamGzipDecompressor<ZlibApi>>();
+        break;
+    case GzipBackend::zlib_ng:
+        impl_ = make_zlib_ng_decompressor();
+        break;
+    case GzipBackend::libdeflate:
+        impl_ = make_libdeflate_decompressor();
+        break;
+    case GzipBackend::parallel:
+        impl_ = std::make_unique<ParallelDecompressor>();
+        break;
+    }
+    if (!impl_)
+        throw Exception{"Could not use gzip backend {}: not available in this build", backend};
+}
+
+GzipDecompressor::~GzipDecompressor() = default;
+
 bool GzipDecompressor::finished() const {
-    return !running_;
+    return impl_->finished();
 }
 
 std::vector<std::byte> GzipDecompressor::operator()(std::span<const std::byte> data) {
@@ -30,32 +102,7 @@ std::vector<std::byte> GzipDecompressor::operator()(std::span<const std::byte> d
 }
 
 void GzipDecompressor::operator()(std::span<const std::byte> data, std::vector<std::byte>& out) {
-    stream_.next_in = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
-    stream_.avail_in = data.size();
-
-    while (stream_.avail_in > 0) {
-        size_t out_offset = out.size();
-        out.resize(out_offset + default_buffer_size);
-        stream_.next_out = reinterpret_cast<unsigned char*>(out.data() + out_offset);
-        stream_.avail_out = default_buffer_size;
-
-        if (!running_) {
-            if (int err = inflateInit2(&stream_, 15 + 16); err)  // max window size + 16 for gzip mode
-                throw Exception{"Could not open gzip decompressor stream, error {}", err};
-            running_ = true;
-        }
-        int ret = inflate(&stream_, Z_NO_FLUSH);
-        if (ret == Z_STREAM_END) {
-            if (int err = inflateEnd(&stream_); err)
-                throw Exception{"Could not close gzip decompressor stream, error {}", err};
-            running_ = false;
-        }
-        else if (ret) {
-            throw Exception{"Could not decompress gzip data, error {}", ret};
-        }
-
-        out.resize(out.size() - stream_.avail_out);
-    }
+    impl_->decompress(data, out);
 }
 
 }  // namespace komankondi::dictgen
@@ -1,14 +1,35 @@
 #pragma once
 
+#include <memory>
 #include <span>
+#include <string_view>
 #include <vector>
 
-#include <zlib.h>
-
 namespace komankondi::dictgen {
 
+enum class GzipBackend {
+    zlib,
+    zlib_ng,
+    libdeflate,
+    parallel,
+};
+
+/// Backends available in this build, zlib and parallel always are.
+std::vector<GzipBackend> gzip_backends();
+
+std::string_view format_as(GzipBackend backend);
+
+
 struct GzipDecompressor {
-    GzipDecompressor() = default;
+    struct Impl {
+        virtual ~Impl() = default;
+
+        virtual bool finished() const = 0;
+        virtual void decompress(std::span<const std::byte> data, std::vector<std::byte>& out) = 0;
+    };
+
+    /// Some backends buffer input (libdeflate decodes the whole of it at once, only fit for benchmarks), it must be flushed by giving an empty span at the end.
+    explicit GzipDecompressor(GzipBackend backend = GzipBackend::zlib);
     ~GzipDecompressor();
     GzipDecompressor(const GzipDecompressor&) = delete;
     GzipDecompressor& operator=(const GzipDecompressor&) = delete;
@@ -21,8 +42,7 @@ struct GzipDecompressor {
     void operator()(std::span<const std::byte> data, std::vector<std::byte>& out);
 
 private:
-    bool running_ = false;
-    z_stream stream_{};
+    std::unique_ptr<Impl> impl_;
 };
 
 }  // namespace komankondi::dictgen
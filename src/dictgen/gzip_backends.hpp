@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "dictgen/gzip.hpp"
+#include "utils/config.hpp"
+#include "utils/exception.hpp"
+#include "utils/log.hpp"
+
+namespace komankondi::dictgen {
+
+/// Streaming decompressor for zlib-like APIs.
+template <typename Api>
+struct StreamGzipDecompressor : GzipDecompressor::Impl {
+    StreamGzipDecompressor() = default;
+    ~StreamGzipDecompressor() override {
+        if (!running_)
+            return;
+
+        if (int err = Api::end(&stream_); err)
+            log::error("Could not cleanup gzip decompressor stream, error {}", err);
+    }
+    StreamGzipDecompressor(const StreamGzipDecompressor&) = delete;
+    StreamGzipDecompressor& operator=(const StreamGzipDecompressor&) = delete;
+    StreamGzipDecompressor(StreamGzipDecompressor&&) noexcept = delete;
+    StreamGzipDecompressor& operator=(StreamGzipDecompressor&&) noexcept = delete;
+
+    bool finished() const override {
+        return !running_;
+    }
+
+    void decompress(std::span<const std::byte> data, std::vector<std::byte>& out) override {
+        stream_.next_in = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
+        stream_.avail_in = data.size();
+
+        while (stream_.avail_in > 0) {
+            size_t out_offset = out.size();
+            out.resize(out_offset + default_buffer_size);
+            stream_.next_out = reinterpret_cast<unsigned char*>(out.data() + out_offset);
+            stream_.avail_out = default_buffer_size;
+
+            if (!running_) {
+                if (int err = Api::init(&stream_); err)
+                    throw Exception{"Could not open gzip decompressor stream, error {}", err};
+                running_ = true;
+            }
+            int ret = Api::inflate(&stream_);
+            if (ret == Api::stream_end) {
+                if (int err = Api::end(&stream_); err)
+                    throw Exception{"Could not close gzip decompressor stream, error {}", err};
+                running_ = false;
+            }
+            else if (ret) {
+                throw Exception{"Could not decompress gzip data, error {}", ret};
+            }
+
+            out.resize(out.size() - stream_.avail_out);
+        }
+    }
+
+private:
+    bool running_ = false;
+    typename Api::Stream stream_{};
+};
+
+
+std::unique_ptr<GzipDecompressor::Impl> make_zlib_ng_decompressor();
+std::unique_ptr<GzipDecompressor::Impl> make_libdeflate_decompressor();
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "dictgen/gzip_backends.hpp"
+#include "utils/exception.hpp"
+
+#ifdef WITH_LIBDEFLATE
+#  include <libdeflate.h>
+
+template <>
+struct std::default_delete<libdeflate_decompressor> {
+    void operator()(libdeflate_decompressor* ptr) const {
+        libdeflate_free_decompressor(ptr);
+    }
+};
+#endif
+
+namespace komankondi::dictgen {
+
+#ifdef WITH_LIBDEFLATE
+
+namespace {
+
+/// Whole-buffer decompressor: input is only decoded when flushed.
+/// libdeflate cannot stream, so the whole compressed data and its decompressed content are held in memory at once,
+/// which only suits benchmarks, not multi-GB dumps.
+struct LibdeflateDecompressor : GzipDecompressor::Impl {
+    LibdeflateDecompressor() {
+        handle_.reset(libdeflate_alloc_decompressor());
+        if (!handle_)
+            throw Exception{"Could not allocate libdeflate decompressor"};
+    }
+
+    bool finished() const override {
+        return input_.empty();
+    }
+
+    void decompress(std::span<const std::byte> data, std::vector<std::byte>& out) override {
+        if (!data.empty()) {
+            input_.insert(input_.end(), data.begin(), data.end());
+            return;
+        }
+
+        if (input_.empty())
+            return;
+        // header and trailer of the smallest member
+        if (input_.size() < 18)
+            throw Exception{"Could not decompress gzip data: truncated stream"};
+
+        // the trailer has the size modulo 4 GiB of the last member, that is the whole data when there is a single one
+        size_t capacity = std::max<size_t>(static_cast<uint32_t>(input_[input_.size() - 4])
+                                                   | static_cast<uint32_t>(input_[input_.size() - 3]) << 8
+                                                   | static_cast<uint32_t>(input_[input_.size() - 2]) << 16
+                                                   | static_cast<uint32_t>(input_[input_.size() - 1]) << 24,
+                                           input_.size());
+        size_t offset = 0;
+        size_t total_out = 0;
+        while (offset < input_.size()) {
+            std::span<const std::byte> member = std::span{input_}.subspan(offset);
+            // the next members are guessed to compress as well as the previous ones
+            if (offset > 0)
+                capacity = std::max(member.size(), static_cast<size_t>(static_cast<double>(total_out) / offset * member.size()));
+
+            size_t out_offset = out.size();
+            while (true) {
+                out.resize(out_offset + capacity);
+                size_t in_size;
+                size_t out_size;
+                libdeflate_result res = libdeflate_gzip_decompress_ex(handle_.get(), member.data(), member.size(),
+                                                                      out.data() + out_offset, capacity, &in_size, &out_size);
+                if (res == LIBDEFLATE_INSUFFICIENT_SPACE) {
+                    capacity *= 2;
+                    continue;
+                }
+                if (res != LIBDEFLATE_SUCCESS)
+                    throw Exception{"Could not decompress gzip data, error {}", static_cast<int>(res)};
+                out.resize(out_offset + out_size);
+                offset += in_size;
+                total_out += out_size;
+                break;
+            }
+        }
+        input_.clear();
+    }
+
+private:
+    std::unique_ptr<libdeflate_decompressor> handle_;
+    std::vector<std::byte> input_;
+};
+
+}  // namespace
+
+
+std::unique_ptr<GzipDecompressor::Impl> make_libdeflate_decompressor() {
+    return std::make_unique<LibdeflateDecompressor>();
+}
+
+#else
+
+std::unique_ptr<GzipDecompressor::Impl> make_libdeflate_decompressor() {
+    return {};
+}
+
+#endif
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,46 @@
+#include <memory>
+
+#include "dictgen/gzip_backends.hpp"
+
+#ifdef WITH_ZLIB_NG
+#  include <zlib-ng.h>
+#endif
+
+namespace komankondi::dictgen {
+
+#ifdef WITH_ZLIB_NG
+
+namespace {
+
+struct ZlibNgApi {
+    using Stream = zng_stream;
+
+    static constexpr int stream_end = Z_STREAM_END;
+
+    static int init(Stream* stream) {
+        return zng_inflateInit2(stream, 15 + 16);  // max window size + 16 for gzip mode
+    }
+    static int inflate(Stream* stream) {
+        return zng_inflate(stream, Z_NO_FLUSH);
+    }
+    static int end(Stream* stream) {
+        return zng_inflateEnd(stream);
+    }
+};
+
+}  // namespace
+
+
+std::unique_ptr<GzipDecompressor::Impl> make_zlib_ng_decompressor() {
+    return std::make_unique<StreamGzipDecompressor<ZlibNgApi>>();
+}
+
+#else
+
+std::unique_ptr<GzipDecompressor::Impl> make_zlib_ng_decompressor() {
+    return {};
+}
+
+#endif
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,241 @@
+#include "html.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+#include "utils/utf8.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == ':';
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+/// Position of the first '<' or '&' from pos, or the size of html if there is none.
+size_t find_markup(std::string_view html, size_t pos) {
+#ifdef __AVX2__
+    const __m256i lt = _mm256_set1_epi8('<');
+    const __m256i amp = _mm256_set1_epi8('&');
+    for (; pos + 32 <= html.size(); pos += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(html.data() + pos));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, lt), _mm256_cmpeq_epi8(chunk, amp)));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+#endif
+    for (; pos < html.size(); ++pos) {
+        if (html[pos] == '<' || html[pos] == '&')
+            return pos;
+    }
+    return pos;
+}
+
+constexpr std::array<std::pair<std::string_view, uint32_t>, 21> named_references{{
+        {"amp", '&'},
+        {"apos", '\''},
+        {"deg", 0xb0},
+        {"gt", '>'},
+        {"hellip", 0x2026},
+        {"laquo", 0xab},
+        {"ldquo", 0x201c},
+        {"lsquo", 0x2018},
+        {"lt", '<'},
+        {"mdash", 0x2014},
+        {"middot", 0xb7},
+        {"minus", 0x2212},
+        {"nbsp", 0xa0},
+        {"ndash", 0x2013},
+        {"quot", '"'},
+        {"raquo", 0xbb},
+        {"rdquo", 0x201d},
+        {"rsquo", 0x2019},
+        {"shy", 0xad},
+        {"thinsp", 0x2009},
+        {"times", 0xd7},
+}};
+static_assert(std::is_sorted(named_references.begin(), named_references.end()));
+
+/// Code point of the character reference between '&' and ';'.
+std::optional<uint32_t> decode_reference(std::string_view reference) {
+    if (reference.starts_with('#')) {
+        bool hex = reference.size() > 1 && (reference[1] == 'x' || reference[1] == 'X');
+        std::string_view digits = reference.substr(hex ? 2 : 1);
+        if (digits.empty() || digits.size() > 8)
+            return {};
+        uint32_t r = 0;
+        for (char c : digits) {
+            if (c >= '0' && c <= '9')
+                r = r * (hex ? 16 : 10) + (c - '0');
+            else if (hex && c >= 'a' && c <= 'f')
+                r = r * 16 + (c - 'a' + 10);
+            else if (hex && c >= 'A' && c <= 'F')
+                r = r * 16 + (c - 'A' + 10);
+            else
+                return {};
+        }
+        if (r == 0 || r > 0x10ffff || (r >= 0xd800 && r < 0xe000))
+            return {};
+        return r;
+    }
+
+    auto it = std::lower_bound(named_references.begin(), named_references.end(), reference,
+                               [](const auto& named, std::string_view name) { return named.first < name; });
+    if (it == named_references.end() || it->first != reference)
+        return {};
+    return it->second;
+}
+
+}  // namespace
+
+
+std::optional<std::string_view> HtmlTag::attribute(std::string_view name) const {
+    size_t i = 0;
+    while (i < attributes.size()) {
+        while (i < attributes.size() && (is_space(attributes[i]) || attributes[i] == '/'))
+            ++i;
+        size_t name_begin = i;
+        while (i < attributes.size() && !is_space(attributes[i]) && attributes[i] != '=' && attributes[i] != '/')
+            ++i;
+        std::string_view attribute_name = attributes.substr(name_begin, i - name_begin);
+        if (attribute_name.empty())
+            break;
+
+        while (i < attributes.size() && is_space(attributes[i]))
+            ++i;
+        std::string_view value;
+        if (i < attributes.size() && attributes[i] == '=') {
+            ++i;
+            while (i < attributes.size() && is_space(attributes[i]))
+                ++i;
+            if (i < attributes.size() && (attributes[i] == '"' || attributes[i] == '\'')) {
+                size_t end = attributes.find(attributes[i], i + 1);
+                if (end == std::string_view::npos)
+                    end = attributes.size();
+                value = attributes.substr(i + 1, end - i - 1);
+                i = end + 1;
+            }
+            else {
+                size_t value_begin = i;
+                while (i < attributes.size() && !is_space(attributes[i]))
+                    ++i;
+                value = attributes.substr(value_begin, i - value_begin);
+            }
+        }
+
+        if (attribute_name == name)
+            return value;
+    }
+    return {};
+}
+
+
+HtmlTokenizer::HtmlTokenizer(std::string_view html) :
+        html_{html} {
+}
+
+std::optional<HtmlTag> HtmlTokenizer::next() {
+    while (true) {
+        size_t begin = html_.find('<', pos_);
+        if (begin == std::string_view::npos || begin + 1 >= html_.size()) {
+            pos_ = html_.size();
+            return {};
+        }
+
+        if (html_.substr(begin, 4) == "<!--") {
+            size_t end = html_.find("-->", begin + 4);
+            pos_ = end == std::string_view::npos ? html_.size() : end + 3;
+            continue;
+        }
+
+        HtmlTag tag;
+        tag.begin = begin;
+        size_t i = begin + 1;
+        if (html_[i] == '/') {
+            tag.closing = true;
+            ++i;
+        }
+        size_t name_begin = i;
+        while (i < html_.size() && is_name_char(html_[i]))
+            ++i;
+        if (i == name_begin) {  // not a tag, like a lone '<' or a doctype
+            pos_ = html_[begin + 1] == '!' ? html_.find('>', begin) : begin + 1;
+            if (pos_ == std::string_view::npos)
+                pos_ = html_.size();
+            continue;
+        }
+        tag.name = html_.substr(name_begin, i - name_begin);
+
+        // find the end of the tag, ignoring '>' in quoted attribute values
+        size_t attributes_begin = i;
+        char quote = 0;
+        for (; i < html_.size(); ++i) {
+            char c = html_[i];
+            if (quote) {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '"' || c == '\'') {
+                quote = c;
+            }
+            else if (c == '>') {
+                break;
+            }
+        }
+        tag.attributes = html_.substr(attributes_begin, i - attributes_begin);
+        tag.end = std::min(i + 1, html_.size());
+        pos_ = tag.end;
+        return tag;
+    }
+}
+
+
+void append_html_text(std::string_view html, std::string& out) {
+    size_t pos = 0;
+    while (pos < html.size()) {
+        size_t markup = find_markup(html, pos);
+        out.append(html.substr(pos, markup - pos));
+        if (markup == html.size())
+            break;
+
+        if (html[markup] == '<') {
+            size_t end = html.find('>', markup + 1);
+            if (end == std::string_view::npos) {  // not a tag
+                out.append(html.substr(markup));
+                break;
+            }
+            pos = end + 1;
+            continue;
+        }
+
+        constexpr size_t max_reference_size = 10;
+        size_t end = html.substr(0, markup + max_reference_size + 2).find(';', markup + 1);
+        std::optional<uint32_t> code;
+        if (end != std::string_view::npos)
+            code = decode_reference(html.substr(markup + 1, end - markup - 1));
+        if (code) {
+            append_utf8(out, *code);
+            pos = end + 1;
+        }
+        else {
+            out += '&';
+            pos = markup + 1;
+        }
+    }
+}
+
+}  // namespace komankondi::dictgen
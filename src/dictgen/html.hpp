@@ -0,0 +1,37 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace komankondi::dictgen {
+
+struct HtmlTag {
+    std::string_view name;
+    std::string_view attributes;
+    bool closing = false;
+
+    /// Position of the tag in the document, text lies between the end of a tag and the beginning of the next one.
+    size_t begin = 0;
+    size_t end = 0;
+
+    std::optional<std::string_view> attribute(std::string_view name) const;
+};
+
+
+/// Single pass over the tags of a document, in linear time, skipping comments.
+struct HtmlTokenizer {
+    explicit HtmlTokenizer(std::string_view html);
+
+    std::optional<HtmlTag> next();
+
+private:
+    std::string_view html_;
+    size_t pos_ = 0;
+};
+
+
+/// Append the text of an html fragment, without its tags and with its character references decoded.
+void append_html_text(std::string_view html, std::string& out);
+
+}  // namespace komankondi::dictgen
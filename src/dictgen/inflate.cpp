@@ -0,0 +1,454 @@
+#include "inflate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace komankondi::dictgen {
+namespace {
+
+static_assert(std::endian::native == std::endian::little);
+
+constexpr std::array<uint16_t, 29> length_base = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> length_extra = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> distance_base = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> distance_extra = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr std::array<uint8_t, 19> code_length_order = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+constexpr int max_code_length = 15;
+
+
+enum class BlockStatus {
+    ok,
+    need_input,
+    invalid,
+};
+
+
+struct BitReader {
+    std::span<const std::byte> input;
+    int64_t bit;
+
+    /// Next bits, least significant first, zero past the end of input.  At least 56 are valid.
+    uint64_t peek() const {
+        int64_t byte = bit / 8;
+        uint64_t r = 0;
+        if (byte + 8 <= std::ssize(input)) {
+            std::memcpy(&r, input.data() + byte, sizeof(r));
+        }
+        else {
+            for (int64_t i = byte; i < std::ssize(input); ++i)
+                r |= static_cast<uint64_t>(input[i]) << ((i - byte) * 8);
+        }
+        return r >> (bit % 8);
+    }
+
+    uint32_t read(int nr_bits) {
+        uint32_t r = peek() & ((uint64_t{1} << nr_bits) - 1);
+        bit += nr_bits;
+        return r;
+    }
+
+    bool overrun() const {
+        return bit > std::ssize(input) * 8;
+    }
+
+    /// A failure close to the end of input may just be caused by missing data.
+    BlockStatus fail() const {
+        return bit + max_code_length > std::ssize(input) * 8 ? BlockStatus::need_input : BlockStatus::invalid;
+    }
+};
+
+
+struct Huffman {
+    static constexpr int fast_bits = 10;
+
+    /// Indexed by the next fast_bits bits: (symbol << 4) | length, or 0 when code is longer.
+    std::array<uint16_t, 1 << fast_bits> fast;
+    std::array<uint16_t, max_code_length + 1> count;
+    std::array<uint16_t, 288> symbols;
+
+    /// Incomplete codes are only accepted when they have a single symbol, or none if allow_empty.
+    bool build(std::span<const uint8_t> lengths, bool allow_empty) {
+        count.fill(0);
+        for (uint8_t length : lengths)
+            ++count[length];
+        count[0] = 0;
+
+        int left = 1;
+        int max_length = 0;
+        for (int length = 1; length <= max_code_length; ++length) {
+            left <<= 1;
+            left -= count[length];
+            if (left < 0)
+                return false;
+            if (count[length])
+                max_length = length;
+        }
+        if (max_length == 0)
+            return allow_empty;
+        if (left > 0 && max_length != 1)
+            return false;
+
+        std::array<uint16_t, max_code_length + 2> offsets;
+        std::array<uint16_t, max_code_length + 1> next_code;
+        offsets[1] = 0;
+        next_code[0] = 0;
+        int code = 0;
+        for (int length = 1; length <= max_code_length; ++length) {
+            offsets[length + 1] = offsets[length] + count[length];
+            code = (code + count[length - 1]) << 1;
+            next_code[length] = code;
+        }
+
+        fast.fill(0);
+        for (int symbol = 0; symbol < std::ssize(lengths); ++symbol) {
+            int length = lengths[symbol];
+            if (length == 0)
+                continue;
+            symbols[offsets[length]++] = symbol;
+
+            int symbol_code = next_code[length]++;
+            if (length > fast_bits)
+                continue;
+            int reversed = 0;
+            for (int i = 0; i < length; ++i)
+                reversed |= ((symbol_code >> i) & 1) << (length - 1 - i);
+            for (int i = reversed; i < (1 << fast_bits); i += 1 << length)
+                fast[i] = (symbol << 4) | length;
+        }
+        return true;
+    }
+
+    /// Returns -1 on invalid code.
+    int decode(BitReader& reader) const {
+        uint64_t bits = reader.peek();
+        if (uint16_t entry = fast[bits & ((1 << fast_bits) - 1)]; entry) {
+            reader.bit += entry & 0xf;
+            return entry >> 4;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int length = 1; length <= max_code_length; ++length) {
+            code |= (bits >> (length - 1)) & 1;
+            int nr_codes = count[length];
+            if (code - first < nr_codes) {
+                reader.bit += length;
+                return symbols[index + code - first];
+            }
+            index += nr_codes;
+            first = (first + nr_codes) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+const Huffman& fixed_literals() {
+    static const Huffman r = [] {
+        std::array<uint8_t, 288> lengths;
+        std::fill(lengths.begin(), lengths.begin() + 144, 8);
+        std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+        std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+        std::fill(lengths.begin() + 280, lengths.end(), 8);
+        Huffman h;
+        h.build(lengths, false);
+        return h;
+    }();
+    return r;
+}
+
+const Huffman& fixed_distances() {
+    static const Huffman r = [] {
+        std::array<uint8_t, 32> lengths;
+        lengths.fill(5);
+        Huffman h;
+        h.build(lengths, false);
+        return h;
+    }();
+    return r;
+}
+
+
+/// Reads the code tables of a dynamic block, after its 3-bit header.
+BlockStatus read_dynamic_tables(BitReader& reader, Huffman& literals, Huffman& distances) {
+    int nr_literals = reader.read(5) + 257;
+    int nr_distances = reader.read(5) + 1;
+    int nr_code_lengths = reader.read(4) + 4;
+    if (nr_literals > 286 || nr_distances > 30)
+        return BlockStatus::invalid;
+
+    std::array<uint8_t, 19> code_length_lengths{};
+    int left = 1 << 7;
+    for (int i = 0; i < nr_code_lengths; ++i) {
+        int length = reader.read(3);
+        code_length_lengths[code_length_order[i]] = length;
+        if (length)
+            left -= 1 << (7 - length);
+    }
+    if (left != 0)  // code length code must be complete, this check is cheap and filters most random data
+        return reader.overrun() ? BlockStatus::need_input : BlockStatus::invalid;
+
+    Huffman code_lengths;
+    if (!code_lengths.build(code_length_lengths, false))
+        return BlockStatus::invalid;
+
+    std::array<uint8_t, 286 + 30> lengths{};
+    int index = 0;
+    while (index < nr_literals + nr_distances) {
+        int symbol = code_lengths.decode(reader);
+        if (symbol < 0)
+            return reader.fail();
+        if (symbol < 16) {
+            lengths[index++] = symbol;
+            continue;
+        }
+
+        int value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (index == 0)
+                return BlockStatus::invalid;
+            value = lengths[index - 1];
+            repeat = 3 + reader.read(2);
+        }
+        else if (symbol == 17) {
+            repeat = 3 + reader.read(3);
+        }
+        else {
+            repeat = 11 + reader.read(7);
+        }
+        if (index + repeat > nr_literals + nr_distances)
+            return reader.overrun() ? BlockStatus::need_input : BlockStatus::invalid;
+        std::fill_n(lengths.begin() + index, repeat, value);
+        index += repeat;
+    }
+    if (reader.overrun())
+        return BlockStatus::need_input;
+
+    if (lengths[256] == 0)  // no end of block code
+        return BlockStatus::invalid;
+    if (!literals.build(std::span{lengths}.first(nr_literals), false))
+        return BlockStatus::invalid;
+    if (!distances.build(std::span{lengths}.subspan(nr_literals, nr_distances), true))
+        return BlockStatus::invalid;
+    return BlockStatus::ok;
+}
+
+
+template <typename Symbol>
+struct Output {
+    std::vector<Symbol> buffer;
+    size_t size = 0;
+
+    void reserve(size_t extra) {
+        if (buffer.size() < size + extra)
+            buffer.resize(std::max(buffer.size() * 2, size + extra));
+    }
+};
+
+template <typename Symbol>
+BlockStatus inflate_codes(BitReader& reader, const Huffman& literals, const Huffman& distances, Output<Symbol>& out) {
+    while (true) {
+        if (reader.overrun())
+            return BlockStatus::need_input;
+        out.reserve(258);
+
+        int symbol = literals.decode(reader);
+        if (symbol < 0)
+            return reader.fail();
+        if (symbol < 256) {
+            out.buffer[out.size++] = static_cast<Symbol>(symbol);
+            continue;
+        }
+        if (symbol == 256)
+            return reader.overrun() ? BlockStatus::need_input : BlockStatus::ok;
+
+        symbol -= 257;
+        if (symbol >= std::ssize(length_base))
+            return reader.fail();
+        int length = length_base[symbol] + reader.read(length_extra[symbol]);
+
+        int distance_symbol = distances.decode(reader);
+        if (distance_symbol < 0 || distance_symbol >= std::ssize(distance_base))
+            return reader.fail();
+        size_t distance = distance_base[distance_symbol] + reader.read(distance_extra[distance_symbol]);
+        if (reader.overrun())
+            return BlockStatus::need_input;
+        if (distance > out.size)
+            return BlockStatus::invalid;
+
+        Symbol* dest = out.buffer.data() + out.size;
+        const Symbol* src = dest - distance;
+        if (distance >= static_cast<size_t>(length)) {
+            std::copy_n(src, length, dest);
+        }
+        else {
+            for (int i = 0; i < length; ++i)
+                dest[i] = src[i];
+        }
+        out.size += length;
+    }
+}
+
+template <typename Symbol>
+BlockStatus inflate_stored(BitReader& reader, Output<Symbol>& out) {
+    reader.bit = (reader.bit + 7) / 8 * 8;
+    uint32_t length = reader.read(16);
+    uint32_t length_complement = reader.read(16);
+    if (reader.overrun())
+        return BlockStatus::need_input;
+    if (length != (~length_complement & 0xffff))
+        return BlockStatus::invalid;
+
+    int64_t byte = reader.bit / 8;
+    if (byte + length > std::ssize(reader.input))
+        return BlockStatus::need_input;
+
+    out.reserve(length);
+    std::transform(reader.input.begin() + byte, reader.input.begin() + byte + length, out.buffer.begin() + out.size,
+                   [](std::byte c) { return static_cast<Symbol>(c); });
+    out.size += length;
+    reader.bit += length * 8;
+    return BlockStatus::ok;
+}
+
+template <typename Symbol>
+BlockStatus inflate_block(BitReader& reader, Output<Symbol>& out, bool& final) {
+    final = reader.read(1);
+    switch (reader.read(2)) {
+    case 0:
+        return inflate_stored(reader, out);
+    case 1:
+        return inflate_codes(reader, fixed_literals(), fixed_distances(), out);
+    case 2: {
+        Huffman literals;
+        Huffman distances;
+        if (BlockStatus status = read_dynamic_tables(reader, literals, distances); status != BlockStatus::ok)
+            return status;
+        return inflate_codes(reader, literals, distances, out);
+    }
+    default:
+        return reader.overrun() ? BlockStatus::need_input : BlockStatus::invalid;
+    }
+}
+
+
+InflateChunk inflate(std::span<const std::byte> input, int64_t begin_bit, int64_t stop_bit, std::span<const std::byte> window, bool window_known) {
+    InflateChunk r;
+    r.begin_bit = begin_bit;
+    r.end_bit = begin_bit;
+
+    Output<uint16_t> marked;
+    Output<std::byte> data;
+    size_t marked_prefix = 0;
+    size_t data_prefix = 0;
+    if (window_known) {
+        window = window.last(std::min<size_t>(window.size(), deflate_window_size));
+        data.buffer.assign(window.begin(), window.end());
+        data.size = data_prefix = window.size();
+    }
+    else {
+        marked.buffer.resize(deflate_window_size);
+        for (int i = 0; i < deflate_window_size; ++i)
+            marked.buffer[i] = inflate_marker + i;
+        marked.size = marked_prefix = deflate_window_size;
+    }
+    size_t marked_end = marked.size;
+    size_t data_end = data.size;
+
+    BitReader reader{input, begin_bit};
+    while (true) {
+        if (reader.bit >= stop_bit) {
+            r.status = InflateStatus::done;
+            break;
+        }
+
+        bool final;
+        BlockStatus status = window_known ? inflate_block(reader, data, final) : inflate_block(reader, marked, final);
+        if (status != BlockStatus::ok) {
+            r.status = status == BlockStatus::need_input ? InflateStatus::need_input : InflateStatus::invalid;
+            break;
+        }
+        r.end_bit = reader.bit;
+        marked_end = marked.size;
+        data_end = data.size;
+
+        if (final) {
+            r.final = true;
+            r.status = InflateStatus::done;
+            break;
+        }
+
+        if (!window_known
+            && marked.size >= marked_prefix + deflate_window_size
+            && std::none_of(marked.buffer.begin() + marked.size - deflate_window_size, marked.buffer.begin() + marked.size,
+                            [](uint16_t symbol) { return symbol >= inflate_marker; }))
+        {
+            window_known = true;
+            data.buffer.resize(deflate_window_size);
+            std::transform(marked.buffer.begin() + marked.size - deflate_window_size, marked.buffer.begin() + marked.size, data.buffer.begin(),
+                           [](uint16_t symbol) { return static_cast<std::byte>(symbol); });
+            data.size = data_prefix = data_end = deflate_window_size;
+        }
+    }
+
+    r.marked.assign(marked.buffer.begin() + marked_prefix, marked.buffer.begin() + std::max(marked_prefix, marked_end));
+    r.data.assign(data.buffer.begin() + data_prefix, data.buffer.begin() + std::max(data_prefix, data_end));
+    return r;
+}
+
+}  // namespace
+
+
+InflateChunk inflate_chunk(std::span<const std::byte> input, int64_t begin_bit, int64_t stop_bit, std::span<const std::byte> window) {
+    return inflate(input, begin_bit, stop_bit, window, true);
+}
+
+InflateChunk inflate_chunk_marked(std::span<const std::byte> input, int64_t begin_bit, int64_t stop_bit) {
+    return inflate(input, begin_bit, stop_bit, {}, false);
+}
+
+InflateChunk find_and_inflate_chunk(std::span<const std::byte> input, int64_t begin_bit, int64_t end_bit, int64_t stop_bit) {
+    end_bit = std::min(end_bit, std::ssize(input) * 8);
+    for (int64_t bit = begin_bit; bit < end_bit; ++bit) {
+        if (!is_block_start_candidate(input, bit))
+            continue;
+        InflateChunk r = inflate_chunk_marked(input, bit, stop_bit);
+        if (r.status == InflateStatus::done || (r.status == InflateStatus::need_input && r.end_bit > bit))
+            return r;
+    }
+    return {};
+}
+
+bool is_block_start_candidate(std::span<const std::byte> input, int64_t bit) {
+    BitReader reader{input, bit};
+    uint64_t header = reader.peek();
+    if (header & 1)  // final blocks are rare, skipping them avoids many false positives
+        return false;
+
+    switch ((header >> 1) & 3) {
+    case 0: {
+        reader.bit = (bit + 3 + 7) / 8 * 8;
+        uint32_t length = reader.read(16);
+        uint32_t length_complement = reader.read(16);
+        return !reader.overrun() && length == (~length_complement & 0xffff);
+    }
+    case 2: {
+        reader.bit += 3;
+        Huffman literals;
+        Huffman distances;
+        return read_dynamic_tables(reader, literals, distances) == BlockStatus::ok;
+    }
+    default:  // fixed blocks have no header to check
+        return false;
+    }
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace komankondi::dictgen {
+
+constexpr int deflate_window_size = 32768;
+
+/// Marked output symbols at or above this value are bytes from the unknown window preceding the chunk, at index (symbol - inflate_marker).
+constexpr uint16_t inflate_marker = 0x8000;
+
+
+enum class InflateStatus {
+    done,
+    need_input,
+    invalid,
+};
+
+struct InflateChunk {
+    InflateStatus status = InflateStatus::invalid;
+    int64_t begin_bit = 0;
+    int64_t end_bit = 0;  ///< after the last completely decoded block
+    bool final = false;   ///< last decoded block is the final one of the stream
+
+    /// Output that may still contain markers, followed by data output once the window got known.
+    std::vector<uint16_t> marked;
+    std::vector<std::byte> data;
+};
+
+
+/// Decode raw deflate blocks from begin_bit until one starts at or after stop_bit, or the final one ends.
+InflateChunk inflate_chunk(std::span<const std::byte> input, int64_t begin_bit, int64_t stop_bit, std::span<const std::byte> window);
+
+/// Same as inflate_chunk, but without knowing the window: references to it are output as markers.
+InflateChunk inflate_chunk_marked(std::span<const std::byte> input, int64_t begin_bit, int64_t stop_bit);
+
+/// Look for a block start in [begin_bit, end_bit) from which inflate_chunk_marked succeeds.
+InflateChunk find_and_inflate_chunk(std::span<const std::byte> input, int64_t begin_bit, int64_t end_bit, int64_t stop_bit);
+
+bool is_block_start_candidate(std::span<const std::byte> input, int64_t bit);
+
+}  // namespace komankondi::dictgen
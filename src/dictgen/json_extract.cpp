@@ -0,0 +1,247 @@
+#include "json_extract.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/exception.hpp"
+#include "utils/utf8.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+struct Scanner {
+    std::string_view json;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(std::string_view what) const {
+        throw Exception{"Could not parse JSON: {} at offset {}", what, pos};
+    }
+
+    void skip_whitespace() {
+        while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' || json[pos] == '\r'))
+            ++pos;
+    }
+
+    char peek() {
+        skip_whitespace();
+        if (pos >= json.size())
+            fail("unexpected end");
+        return json[pos];
+    }
+
+    void expect(char c) {
+        if (peek() != c)
+            fail(fmt::format("expected '{}'", c));
+        ++pos;
+    }
+
+    /// Contents of the string starting at pos, still escaped.
+    std::string_view raw_string(bool& escaped) {
+        expect('"');
+        size_t begin = pos;
+        escaped = false;
+        while (true) {
+            size_t end = json.find_first_of(R"("\)", pos);
+            if (end == std::string_view::npos)
+                fail("unterminated string");
+            if (json[end] == '"') {
+                pos = end + 1;
+                return json.substr(begin, end - begin);
+            }
+            escaped = true;
+            pos = end + 2;
+        }
+    }
+
+    void skip_value() {
+        char c = peek();
+        if (c == '"') {
+            bool escaped;
+            raw_string(escaped);
+            return;
+        }
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (true) {
+                size_t next = json.find_first_of(R"("{}[])", pos);
+                if (next == std::string_view::npos)
+                    fail("unterminated value");
+                pos = next;
+                if (json[pos] == '"') {
+                    bool escaped;
+                    raw_string(escaped);
+                    continue;
+                }
+                ++pos;
+                depth += json[pos - 1] == '{' || json[pos - 1] == '[' ? 1 : -1;
+                if (depth == 0)
+                    return;
+            }
+        }
+        size_t end = json.find_first_of(",}] \t\n\r", pos);
+        pos = end == std::string_view::npos ? json.size() : end;
+    }
+
+    /// Walk an object, calling visitor with each key, which must consume the value and return whether to go on.
+    template <typename Visitor>
+    void visit_object(Visitor&& visitor) {
+        expect('{');
+        if (peek() == '}') {
+            ++pos;
+            return;
+        }
+        while (true) {
+            bool escaped;
+            std::string_view key = raw_string(escaped);
+            expect(':');
+            if (!visitor(key))
+                return;
+            char c = peek();
+            ++pos;
+            if (c == '}')
+                return;
+            if (c != ',')
+                fail("expected ',' or '}'");
+        }
+    }
+
+    std::string_view string(JsonStorage& storage) {
+        bool escaped;
+        std::string_view raw = raw_string(escaped);
+        if (!escaped)
+            return raw;
+        return storage.emplace_back(unescape(raw));
+    }
+
+    uint32_t hex4(std::string_view raw, size_t i) const {
+        if (i + 4 > raw.size())
+            fail("truncated unicode escape");
+        uint32_t r = 0;
+        for (char c : raw.substr(i, 4)) {
+            r <<= 4;
+            if (c >= '0' && c <= '9')
+                r |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                r |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                r |= c - 'A' + 10;
+            else
+                fail("invalid unicode escape");
+        }
+        return r;
+    }
+
+    std::string unescape(std::string_view raw) const {
+        std::string r;
+        r.reserve(raw.size());
+        size_t i = 0;
+        while (true) {
+            size_t backslash = raw.find('\\', i);
+            r.append(raw.substr(i, backslash - i));
+            if (backslash == std::string_view::npos)
+                return r;
+            i = backslash + 2;
+            switch (raw[backslash + 1]) {
+            case '"': r += '"'; break;
+            case '\\': r += '\\'; break;
+            case '/': r += '/'; break;
+            case 'b': r += '\b'; break;
+            case 'f': r += '\f'; break;
+            case 'n': r += '\n'; break;
+            case 'r': r += '\r'; break;
+            case 't': r += '\t'; break;
+            case 'u': {
+                uint32_t code = hex4(raw, i);
+                i += 4;
+                if (code >= 0xd800 && code < 0xdc00 && raw.substr(i, 2) == R"(\u)") {
+                    uint32_t low = hex4(raw, i + 2);
+                    if (low >= 0xdc00 && low < 0xe000) {
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        i += 6;
+                    }
+                }
+                append_utf8(r, code);
+                break;
+            }
+            default:
+                fail("invalid escape sequence");
+            }
+        }
+    }
+};
+
+}  // namespace
+
+
+JsonArticle extract_article(std::string_view json, JsonStorage& storage) {
+    Scanner scanner{json};
+    std::optional<std::string_view> name;
+    std::optional<std::string_view> html;
+
+    scanner.visit_object([&](std::string_view key) {
+        if (key == "name" && !name) {
+            name = scanner.string(storage);
+        }
+        else if (key == "article_body" && !html) {
+            scanner.visit_object([&](std::string_view key) {
+                if (key != "html" || html) {
+                    scanner.skip_value();
+                    return true;
+                }
+                html = scanner.string(storage);
+                return !name;
+            });
+        }
+        else {
+            scanner.skip_value();
+        }
+        return !name || !html;  // no need to read further once both are found
+    });
+
+    if (!name)
+        throw Exception{"Could not find name in JSON record"};
+    if (!html)
+        throw Exception{"Could not find article_body.html in JSON record"};
+    return {*name, *html};
+}
+
+std::vector<JsonArticle> extract_articles(std::string_view ndjson, JsonStorage& storage) {
+    std::vector<std::string_view> lines;
+    while (!ndjson.empty()) {
+        size_t size = ndjson.find('\n');
+        lines.push_back(ndjson.substr(0, size));
+        ndjson = size == std::string_view::npos ? std::string_view{} : ndjson.substr(size + 1);
+    }
+    return extract_articles(lines, storage);
+}
+
+std::vector<JsonArticle> extract_articles(std::span<const std::string_view> lines, JsonStorage& storage) {
+    std::vector<JsonArticle> r;
+    r.reserve(lines.size());
+    for (std::string_view line : lines) {
+        if (line.find_first_not_of(" \t\r\n") != std::string_view::npos)
+            r.push_back(extract_article(line, storage));
+    }
+    return r;
+}
+
+std::vector<std::span<const std::string_view>> split_lines(std::span<const std::string_view> lines, int64_t batch_cost, int64_t line_cost) {
+    std::vector<std::span<const std::string_view>> r;
+    size_t begin = 0;
+    int64_t cost = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        cost += std::ssize(lines[i]) + line_cost;
+        if (cost >= batch_cost || i + 1 == lines.size()) {
+            r.push_back(lines.subspan(begin, i + 1 - begin));
+            begin = i + 1;
+            cost = 0;
+        }
+    }
+    return r;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace komankondi::dictgen {
+
+/// Fields of an enterprise dump record.
+struct JsonArticle {
+    std::string_view name;
+    std::string_view html;
+};
+
+/// Holds fields that had to be unescaped, views into it stay valid as long as it lives.
+using JsonStorage = std::deque<std::string>;
+
+
+/// Pull name and article_body.html out of a record, without parsing the rest of it.
+/// Fields point into the record when they have no escape sequence, else into storage.
+JsonArticle extract_article(std::string_view json, JsonStorage& storage);
+
+/// Same as extract_article, for each of newline-delimited records.
+std::vector<JsonArticle> extract_articles(std::string_view ndjson, JsonStorage& storage);
+
+/// Same as extract_articles, for records already split in lines.
+std::vector<JsonArticle> extract_articles(std::span<const std::string_view> lines, JsonStorage& storage);
+
+/// Split lines into consecutive batches costing about batch_cost each, a line costing its size plus line_cost.
+/// A line costing more than batch_cost is a batch on its own.
+std::vector<std::span<const std::string_view>> split_lines(std::span<const std::string_view> lines, int64_t batch_cost, int64_t line_cost);
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,168 @@
+#include "language_spec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dictgen/html.hpp"
+#include "utils/exception.hpp"
+#include "utils/hasher.hpp"
+#include "utils/hex.hpp"
+#include "utils/iequal.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+/// To bump when the words extracted from a dump change for a same spec, to invalidate caches of them.
+constexpr uint32_t extraction_version = 2;
+
+void hash_string(Hasher& hasher, std::string_view str) {
+    uint64_t size = str.size();
+    hasher.update(std::as_bytes(std::span{&size, 1}));
+    hasher.update(std::as_bytes(std::span{str}));
+}
+
+bool is_heading(std::string_view tag_name) {
+    return tag_name.size() == 2 && tag_name[0] == 'h' && tag_name[1] >= '1' && tag_name[1] <= '6';
+}
+
+bool is_list(std::string_view tag_name) {
+    return tag_name == "ol" || tag_name == "ul" || tag_name == "dl";
+}
+
+}  // namespace
+
+
+LanguageSpec find_language_spec(std::string_view query) {
+    if (iequal(query, std::string_view{"english"}.substr(0, query.length()))) {
+        return {"English",
+                "en",
+                "English",
+                {"Adjective", "Adverb", "Conjunction", "Determiner", "Interjection", "Noun", "Phrase",
+                 "Postposition", "Preposition", "Pronoun", "Proverb", "Verb"},
+                {}};
+    }
+
+    if (iequal(query, std::string_view{"french"}.substr(0, query.length()))) {
+        return {"French",
+                "fr",
+                "Français",
+                {"Adjectif", "Adverbe", "Conjonction", "Interjection", "Locution", "Nom_commun", "Onomatopée",
+                 "Postposition", "Préposition", "Pronom", "Proverbe", "Verbe"},
+                {R"("./Modèle:mercihabitants")"}};
+    }
+
+    throw Exception{"Could not find a language that starts with {}", query};
+}
+
+
+std::string hash(const LanguageSpec& language_spec) {
+    Hasher hasher{"sha256"};
+    hasher.update(std::as_bytes(std::span{&extraction_version, 1}));
+    hash_string(hasher, language_spec.code);
+    hash_string(hasher, language_spec.section_id);
+    for (const std::vector<std::string>* list : {&language_spec.form_ids, &language_spec.skip_markers}) {
+        uint64_t size = list->size();
+        hasher.update(std::as_bytes(std::span{&size, 1}));
+        for (const std::string& str : *list)
+            hash_string(hasher, str);
+    }
+    std::vector<std::byte> digest = hasher.finish();
+    return to_hex(std::span{digest}.first(8));
+}
+
+
+std::vector<ArticleForm> parse_article(std::string_view html, const LanguageSpec& language_spec) {
+    std::vector<ArticleForm> r;
+
+    std::optional<size_t> section_begin;
+    size_t section_end = html.size();
+    bool in_form = false;
+    bool want_form_name = false;
+    std::vector<std::string_view> lists;  // open lists in the current form
+    std::optional<size_t> definition_begin;
+    size_t text_begin = 0;
+
+    auto end_definition = [&](size_t end) {
+        // the line break before a nested list is not part of the definition
+        if (definition_begin) {
+            std::string_view definition = html.substr(*definition_begin, end - *definition_begin);
+            r.back().definitions.push_back(definition.substr(0, definition.find_last_not_of(" \t\n\r\f") + 1));
+        }
+        definition_begin.reset();
+    };
+
+    HtmlTokenizer tokenizer{html};
+    while (std::optional<HtmlTag> tag = tokenizer.next()) {
+        std::string_view text = html.substr(text_begin, tag->begin - text_begin);
+        text_begin = tag->end;
+
+        if (!section_begin) {
+            if (tag->name == "h2" && !tag->closing && tag->attribute("id") == language_spec.section_id)
+                section_begin = tag->begin;
+            continue;
+        }
+
+        if (want_form_name && !text.empty()) {
+            r.back().name = text;
+            want_form_name = false;
+        }
+
+        if (is_heading(tag->name) && !tag->closing) {
+            end_definition(tag->begin);
+            in_form = false;
+            want_form_name = false;
+            lists.clear();
+
+            if (tag->name == "h2") {
+                section_end = tag->begin;
+                break;
+            }
+            if (tag->name == "h3") {
+                std::string_view id = tag->attribute("id").value_or("");
+                if (std::any_of(language_spec.form_ids.begin(), language_spec.form_ids.end(),
+                                [&](const std::string& form_id) { return id.starts_with(form_id); })) {
+                    r.emplace_back();
+                    in_form = true;
+                    want_form_name = true;
+                }
+            }
+            continue;
+        }
+        if (!in_form)
+            continue;
+
+        if (is_list(tag->name)) {
+            end_definition(tag->begin);
+            if (!tag->closing) {
+                lists.push_back(tag->name);
+            }
+            else if (auto it = std::find(lists.rbegin(), lists.rend(), tag->name); it != lists.rend()) {
+                lists.erase(std::next(it).base(), lists.end());
+            }
+        }
+        else if (tag->name == "li") {
+            end_definition(tag->begin);
+            // items of unordered and description lists are examples or quotations, not definitions
+            if (!tag->closing && std::all_of(lists.begin(), lists.end(), [](std::string_view list) { return list == "ol"; }))
+                definition_begin = tag->end;
+        }
+    }
+    end_definition(section_end);
+
+    if (!section_begin)
+        return {};
+    std::string_view section = html.substr(*section_begin, section_end - *section_begin);
+    if (std::any_of(language_spec.skip_markers.begin(), language_spec.skip_markers.end(),
+                    [&](const std::string& marker) { return section.find(marker) != std::string_view::npos; }))
+        return {};
+
+    std::erase_if(r, [](const ArticleForm& form) { return form.name.empty(); });
+    return r;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace komankondi::dictgen {
+
+/// What tells articles of a language apart in Wiktionary dumps.
+struct LanguageSpec {
+    std::string name;
+    std::string code;
+
+    std::string section_id;                  ///< id of the h2 heading of the language section
+    std::vector<std::string> form_ids;       ///< id prefixes of the h3 headings of parts of speech
+    std::vector<std::string> skip_markers;   ///< sections containing one of these are ignored
+};
+
+LanguageSpec find_language_spec(std::string_view query);
+
+/// Short hex digest of the spec and of the version of the extraction code, changing whenever extracted words may.
+std::string hash(const LanguageSpec& language_spec);
+
+
+struct ArticleForm {
+    std::string_view name;
+    std::vector<std::string_view> definitions;  ///< html of each definition, without its examples and sub-definitions
+};
+
+/// Forms found in the language section of an article, in a single pass over its html.
+std::vector<ArticleForm> parse_article(std::string_view html, const LanguageSpec& language_spec);
+
+}  // namespace komankondi::dictgen
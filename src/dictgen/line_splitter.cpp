@@ -0,0 +1,72 @@
+#include "line_splitter.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "utils/buffer_pool.hpp"
+#include "utils/newlines.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+constexpr size_t min_carry_capacity = 256 * 1024;
+
+std::string_view as_string_view(std::span<const std::byte> data) {
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+}  // namespace
+
+
+LineSplitter::LineSplitter(BufferPool& pool) :
+        pool_{pool} {
+}
+
+bool LineSplitter::finished() const {
+    return partial_->empty();
+}
+
+void LineSplitter::operator()(std::span<const std::byte> piece, Lines& out) {
+    newlines_.clear();
+    find_newlines(as_string_view(piece), newlines_);
+
+    size_t begin = 0;
+    auto newline = newlines_.begin();
+    if (!partial_->empty()) {
+        if (newline == newlines_.end()) {
+            partial_->insert(partial_->end(), piece.begin(), piece.end());
+            return;
+        }
+        begin = *newline++ + 1;
+        partial_->reserve(partial_->size() + begin);
+        partial_->insert(partial_->end(), piece.begin(), piece.begin() + begin);
+        finish(out);
+    }
+
+    out.lines.reserve(out.lines.size() + (newlines_.end() - newline));
+    for (; newline != newlines_.end(); ++newline) {
+        out.lines.push_back(as_string_view(piece.subspan(begin, *newline + 1 - begin)));
+        begin = *newline + 1;
+    }
+    carry(piece.subspan(begin));
+}
+
+void LineSplitter::finish(Lines& out) {
+    if (partial_->empty())
+        return;
+    out.lines.push_back(as_string_view(*partial_));
+    // moving the buffer keeps its memory, and so the line valid
+    out.copies.push_back(std::exchange(partial_, {}));
+}
+
+void LineSplitter::carry(std::span<const std::byte> tail) {
+    // recycled buffers large enough for most whole lines, for neither the copy of the tail nor its completion to allocate
+    if (partial_->capacity() < tail.size())
+        partial_ = pool_.get(std::max(tail.size(), min_carry_capacity));
+    partial_->assign(tail.begin(), tail.end());
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "utils/buffer_pool.hpp"
+
+namespace komankondi::dictgen {
+
+/// Whole lines of a text given in consecutive pieces, only copying the lines straddling pieces.
+struct LineSplitter {
+    struct Lines {
+        std::vector<std::string_view> lines;     ///< with their newline, pointing into pieces or copies
+        std::vector<BufferPool::Buffer> copies;  ///< of lines straddling pieces
+    };
+
+    explicit LineSplitter(BufferPool& pool);
+
+    /// Whether the text given so far ends with a whole line.
+    bool finished() const;
+
+    /// Append the lines ending in piece, which must then outlive the use of out.
+    void operator()(std::span<const std::byte> piece, Lines& out);
+
+    /// Append the last line of the text even though it has no newline, to start splitting another text.
+    void finish(Lines& out);
+
+private:
+    BufferPool& pool_;
+    BufferPool::Buffer partial_;
+    std::vector<size_t> newlines_;
+
+    void carry(std::span<const std::byte> tail);
+};
+
+}  // namespace komankondi::dictgen
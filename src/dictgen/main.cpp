@@ -1,11 +1,14 @@
 #include <exception>
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
 
 #include <fmt/core.h>
 
+#include "dict/format.hpp"
+#include "dictgen/gzip.hpp"
 #include "dictgen/wiktionary.hpp"
 #include "utils/cli.hpp"
 #include "utils/log.hpp"
@@ -20,8 +23,30 @@ int main(int argc, char** argv) {
         catch_termination_signal();
 
         Cli cli;
-        bool cache = true;
-        cli.add_flag("--cache,!--no-cache", cache, "Cache downloaded data");
+        GenerateOptions options;
+        cli.add_flag("--cache,!--no-cache", options.cache, "Cache downloaded data");
+        cli.add_flag("--incremental,!--no-incremental", options.incremental,
+                     "Only extract again articles that changed since the previous dictionary");
+        std::map<std::string, GzipBackend> gzip_backend_names;
+        for (GzipBackend backend : gzip_backends())
+            gzip_backend_names.emplace(fmt::to_string(backend), backend);
+        cli.add_option("--gzip", options.gzip_backend,
+                       "Library used to decompress data, parallel uses multiple threads, "
+                       "libdeflate holds the whole dump in memory and is only meant for benchmarks")
+                ->transform(CLI::CheckedTransformer(gzip_backend_names, CLI::ignore_case));
+        std::map<std::string, dict::Format> format_names;
+        for (dict::Format f : {dict::Format::sqlite, dict::Format::native})
+            format_names.emplace(fmt::to_string(f), f);
+        cli.add_option("--format", options.format, "Format of the dictionary, native is read-only and faster to open")
+                ->transform(CLI::CheckedTransformer(format_names, CLI::ignore_case));
+        cli.add_flag("--full-text", options.full_text, "Index the terms of descriptions to search words by them");
+        cli.add_flag("--near-words", options.near_words, "Index words to find those near misspelled answers");
+        cli.add_option("--connections", options.nr_connections, "Number of concurrent connections to download data with")
+                ->check(CLI::PositiveNumber);
+        cli.add_option("--dump-host", options.dump_host, "Scheme, host and port of the server to download Wiktionary dumps from");
+        cli.add_option("--metrics", options.metrics_path,
+                       "File to export metrics of each stage of the pipeline to every 2 seconds, as json if it ends with .json, "
+                       "else in Prometheus text format");
         std::string dictionary = fmt::format("{}/<language>.dict", get_data_directory());
         cli.add_option("-o,--dictionary", dictionary, "Path to the dictionary");
 
@@ -41,7 +66,7 @@ int main(int argc, char** argv) {
         if (dictionary_path.has_parent_path())
             std::filesystem::create_directories(dictionary_path.parent_path());
 
-        generate_dictionary(dictionary, language_spec, cache);
+        generate_dictionary(dictionary, language_spec, options);
     }
     catch (const std::exception& ex) {
         log::error("{}", ex.what());
@@ -0,0 +1,224 @@
+#include "parallel_gzip.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <zlib.h>
+
+#include "dictgen/inflate.hpp"
+#include "utils/exception.hpp"
+#include "utils/math.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+uint32_t read_le32(std::span<const std::byte> data) {
+    return static_cast<uint32_t>(data[0])
+           | static_cast<uint32_t>(data[1]) << 8
+           | static_cast<uint32_t>(data[2]) << 16
+           | static_cast<uint32_t>(data[3]) << 24;
+}
+
+std::byte resolve(uint16_t symbol, std::span<const std::byte> window) {
+    if (symbol < inflate_marker)
+        return static_cast<std::byte>(symbol);
+    int index = symbol - inflate_marker - (deflate_window_size - std::ssize(window));
+    if (index < 0)
+        throw Exception{"Could not decompress gzip data: reference before the start of the stream"};
+    return window[index];
+}
+
+/// Window following the given chunk, knowing the one preceding it.
+std::vector<std::byte> next_window(std::span<const std::byte> window, const InflateChunk& chunk) {
+    size_t from_data = std::min<size_t>(chunk.data.size(), deflate_window_size);
+    size_t from_marked = std::min(chunk.marked.size(), deflate_window_size - from_data);
+    size_t from_window = std::min(window.size(), deflate_window_size - from_data - from_marked);
+
+    std::vector<std::byte> r;
+    r.reserve(from_window + from_marked + from_data);
+    r.insert(r.end(), window.end() - from_window, window.end());
+    std::transform(chunk.marked.end() - from_marked, chunk.marked.end(), std::back_inserter(r),
+                   [&](uint16_t symbol) { return resolve(symbol, window); });
+    r.insert(r.end(), chunk.data.end() - from_data, chunk.data.end());
+    return r;
+}
+
+}  // namespace
+
+
+ParallelGzipDecompressor::ParallelGzipDecompressor(int chunk_size) :
+        chunk_size_{chunk_size} {
+}
+
+bool ParallelGzipDecompressor::finished() const {
+    return state_ == State::idle;
+}
+
+void ParallelGzipDecompressor::operator()(std::span<const std::byte> data, std::vector<std::byte>& out) {
+    input_.insert(input_.end(), data.begin(), data.end());
+    bool flush = data.empty();
+
+    while (true) {
+        if (state_ == State::idle) {
+            if (bit_ / 8 >= std::ssize(input_))
+                break;
+            state_ = State::header;
+        }
+        if (state_ == State::header) {
+            if (!parse_header())
+                break;
+            state_ = State::deflate;
+        }
+        if (state_ == State::deflate) {
+            if (!inflate_round(out, flush))
+                break;
+            continue;
+        }
+        if (state_ == State::trailer) {
+            if (!parse_trailer())
+                break;
+            state_ = State::idle;
+        }
+    }
+
+    if (int64_t consumed = bit_ / 8; consumed > std::ssize(input_) / 2) {
+        input_.erase(input_.begin(), input_.begin() + consumed);
+        bit_ -= consumed * 8;
+    }
+}
+
+bool ParallelGzipDecompressor::parse_header() {
+    std::span<const std::byte> header = std::span{input_}.subspan(bit_ / 8);
+    if (header.size() < 10)
+        return false;
+    if (header[0] != std::byte{0x1f} || header[1] != std::byte{0x8b} || header[2] != std::byte{8})
+        throw Exception{"Could not decompress gzip data: invalid header"};
+
+    int flags = static_cast<int>(header[3]);
+    if (flags & 0xe0)
+        throw Exception{"Could not decompress gzip data: unknown header flags {:#x}", flags};
+
+    size_t size = 10;
+    if (flags & 0x04) {  // extra field
+        if (header.size() < size + 2)
+            return false;
+        size += 2 + (static_cast<size_t>(header[size]) | static_cast<size_t>(header[size + 1]) << 8);
+    }
+    for (int flag : {0x08, 0x10}) {  // file name and comment
+        if (!(flags & flag))
+            continue;
+        auto it = std::find(header.begin() + std::min(size, header.size()), header.end(), std::byte{0});
+        if (it == header.end())
+            return false;
+        size = it - header.begin() + 1;
+    }
+    if (flags & 0x02)  // header crc
+        size += 2;
+    if (header.size() < size)
+        return false;
+
+    bit_ += size * 8;
+    window_.clear();
+    crc_ = crc32(0, nullptr, 0);
+    size_ = 0;
+    return true;
+}
+
+bool ParallelGzipDecompressor::parse_trailer() {
+    bit_ = ceil(bit_, int64_t{8});
+    std::span<const std::byte> trailer = std::span{input_}.subspan(bit_ / 8);
+    if (trailer.size() < 8)
+        return false;
+
+    if (uint32_t crc = read_le32(trailer); crc != crc_)
+        throw Exception{"Could not decompress gzip data: crc is {:#x}, expected {:#x}", crc_, crc};
+    if (uint32_t size = read_le32(trailer.subspan(4)); size != size_)
+        throw Exception{"Could not decompress gzip data: size is {}, expected {}", size_, size};
+
+    bit_ += 8 * 8;
+    return true;
+}
+
+bool ParallelGzipDecompressor::inflate_round(std::vector<std::byte>& out, bool flush) {
+    int64_t chunk_bits = int64_t{chunk_size_} * 8;
+    int64_t available_bits = std::ssize(input_) * 8 - bit_;
+    int max_chunks = tbb::this_task_arena::max_concurrency();
+
+    int nr_chunks = max_chunks;
+    if (flush) {
+        nr_chunks = std::clamp<int64_t>(ceil_div(available_bits, chunk_bits), 1, max_chunks);
+    }
+    else if (available_bits < (max_chunks + 1) * chunk_bits) {  // keep a chunk of margin so the last one can finish its last block
+        return false;
+    }
+
+    std::vector<int64_t> starts;
+    for (int i = 0; i <= nr_chunks; ++i)
+        starts.push_back(bit_ + i * chunk_bits);
+
+    std::vector<InflateChunk> chunks(nr_chunks);
+    tbb::parallel_for(0, nr_chunks, [&](int i) {
+        if (i == 0)
+            chunks[i] = inflate_chunk(input_, bit_, starts[1], window_);
+        else
+            chunks[i] = find_and_inflate_chunk(input_, starts[i], starts[i + 1], starts[i + 1]);
+    });
+
+    // propagate windows from one chunk to the next, and decode again those that did not start where the previous one ended
+    std::vector<std::vector<std::byte>> windows;
+    windows.push_back(std::move(window_));
+    int64_t end_bit = bit_;
+    int nr_used = 0;
+    bool final = false;
+    for (int i = 0; i < nr_chunks; ++i) {
+        InflateChunk& chunk = chunks[i];
+        if (chunk.status == InflateStatus::invalid || chunk.begin_bit != end_bit)
+            chunk = inflate_chunk(input_, end_bit, starts[i + 1], windows.back());
+        if (chunk.status == InflateStatus::invalid)
+            throw Exception{"Could not decompress gzip data: invalid deflate stream"};
+        if (chunk.end_bit == end_bit)
+            break;
+
+        ++nr_used;
+        end_bit = chunk.end_bit;
+        windows.push_back(next_window(windows.back(), chunk));
+        if (chunk.final) {
+            final = true;
+            break;
+        }
+        if (chunk.status == InflateStatus::need_input)
+            break;
+    }
+    window_ = std::move(windows[nr_used]);
+    if (nr_used == 0)
+        return false;
+
+    std::vector<size_t> offsets{out.size()};
+    for (int i = 0; i < nr_used; ++i)
+        offsets.push_back(offsets.back() + chunks[i].marked.size() + chunks[i].data.size());
+    out.resize(offsets.back());
+
+    std::vector<uint32_t> crcs(nr_used);
+    tbb::parallel_for(0, nr_used, [&](int i) {
+        const InflateChunk& chunk = chunks[i];
+        auto it = std::transform(chunk.marked.begin(), chunk.marked.end(), out.begin() + offsets[i],
+                                 [&](uint16_t symbol) { return resolve(symbol, windows[i]); });
+        std::copy(chunk.data.begin(), chunk.data.end(), it);
+        crcs[i] = crc32_z(0, reinterpret_cast<const unsigned char*>(out.data() + offsets[i]), offsets[i + 1] - offsets[i]);
+    });
+
+    for (int i = 0; i < nr_used; ++i) {
+        crc_ = crc32_combine(crc_, crcs[i], offsets[i + 1] - offsets[i]);
+        size_ += offsets[i + 1] - offsets[i];
+    }
+    bit_ = end_bit;
+    if (final)
+        state_ = State::trailer;
+    return true;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace komankondi::dictgen {
+
+/// Gzip decompressor splitting the deflate stream in chunks that are decoded by multiple threads.
+///
+/// Chunks other than the first start at speculatively found block boundaries and are decoded without knowing the preceding
+/// window; their output holds markers that are resolved once the previous chunks have been decoded.
+/// Input is buffered until there is enough to keep all threads busy, so it must be flushed with an empty span at the end.
+struct ParallelGzipDecompressor {
+    static constexpr int default_chunk_size = 1 << 20;
+
+    explicit ParallelGzipDecompressor(int chunk_size = default_chunk_size);
+
+    bool finished() const;
+
+    void operator()(std::span<const std::byte> data, std::vector<std::byte>& out);
+
+private:
+    enum class State {
+        idle,
+        header,
+        deflate,
+        trailer,
+    };
+
+    int chunk_size_;
+    State state_ = State::idle;
+    std::vector<std::byte> input_;
+    int64_t bit_ = 0;
+    std::vector<std::byte> window_;
+    uint32_t crc_ = 0;
+    uint32_t size_ = 0;
+
+    bool parse_header();
+    bool parse_trailer();
+    bool inflate_round(std::vector<std::byte>& out, bool flush);
+};
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,169 @@
+#include "pipeline_metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+#include <tbb/task_arena.h>
+
+#include "utils/exception.hpp"
+#include "utils/file.hpp"
+#include "utils/log.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+constexpr std::array<PipelineStage, nr_pipeline_stages> pipeline_stages = {
+        PipelineStage::fetch, PipelineStage::gzip, PipelineStage::tar, PipelineStage::parse, PipelineStage::write};
+
+bool is_serial(PipelineStage stage) {
+    return stage != PipelineStage::parse;
+}
+
+double to_seconds(int64_t ns) {
+    return static_cast<double>(ns) / 1e9;
+}
+
+}  // namespace
+
+
+std::string_view format_as(PipelineStage stage) {
+    switch (stage) {
+    case PipelineStage::fetch: return "fetch";
+    case PipelineStage::gzip: return "gzip";
+    case PipelineStage::tar: return "tar";
+    case PipelineStage::parse: return "parse";
+    case PipelineStage::write: return "write";
+    }
+    throw Exception{"Could not format unknown pipeline stage {}", static_cast<int>(stage)};
+}
+
+
+PipelineMetrics::Timer::Timer(PipelineMetrics& metrics, PipelineStage stage, int64_t bytes_in) :
+        metrics_{metrics},
+        stage_{stage},
+        start_{Clock::now()} {
+    Counters& counters = metrics_.stages_[static_cast<int>(stage_)];
+    counters.bytes_in.fetch_add(bytes_in, std::memory_order::relaxed);
+    if (is_serial(stage_))
+        counters.wait_ns.fetch_add(std::chrono::nanoseconds{start_ - counters.last_end}.count(), std::memory_order::relaxed);
+}
+
+void PipelineMetrics::Timer::done(int64_t bytes_out) {
+    Clock::time_point end = Clock::now();
+    Counters& counters = metrics_.stages_[static_cast<int>(stage_)];
+    counters.items.fetch_add(1, std::memory_order::relaxed);
+    counters.bytes_out.fetch_add(bytes_out, std::memory_order::relaxed);
+    counters.busy_ns.fetch_add(std::chrono::nanoseconds{end - start_}.count(), std::memory_order::relaxed);
+    if (is_serial(stage_))
+        counters.last_end = end;
+}
+
+
+PipelineMetrics::PipelineMetrics() :
+        start_{Clock::now()} {
+    for (Counters& counters : stages_)
+        counters.last_end = start_;
+}
+
+PipelineMetrics::Stats PipelineMetrics::stats(PipelineStage stage) const {
+    const Counters& counters = stages_[static_cast<int>(stage)];
+    Stats r{counters.items.load(std::memory_order::relaxed),
+            counters.bytes_in.load(std::memory_order::relaxed),
+            counters.bytes_out.load(std::memory_order::relaxed),
+            to_seconds(counters.busy_ns.load(std::memory_order::relaxed)),
+            to_seconds(counters.wait_ns.load(std::memory_order::relaxed))};
+
+    double elapsed_now = elapsed();
+    int nr_threads = is_serial(stage) ? 1 : tbb::this_task_arena::max_concurrency();
+    if (elapsed_now > 0)
+        r.utilization = r.busy / (elapsed_now * nr_threads);
+    return r;
+}
+
+double PipelineMetrics::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - start_).count();
+}
+
+std::string PipelineMetrics::to_json() const {
+    std::string r = fmt::format(R"({{"elapsed_seconds":{:.3f},"stages":{{)", elapsed());
+    for (PipelineStage stage : pipeline_stages) {
+        Stats s = stats(stage);
+        if (stage != pipeline_stages.front())
+            r += ',';
+        r += fmt::format(R"("{}":{{"items":{},"bytes_in":{},"bytes_out":{},"busy_seconds":{:.3f},"wait_seconds":{:.3f},"utilization":{:.3f}}})",
+                         stage, s.items, s.bytes_in, s.bytes_out, s.busy, s.wait, s.utilization);
+    }
+    r += "}}\n";
+    return r;
+}
+
+std::string PipelineMetrics::to_prometheus() const {
+    struct Metric {
+        std::string_view name;
+        std::string_view type;
+        std::string_view help;
+        double (*value)(const Stats& stats);
+    };
+    static constexpr std::array<Metric, 6> metrics = {
+            Metric{"items_total", "counter", "Calls of the filter of the stage", [](const Stats& s) { return static_cast<double>(s.items); }},
+            Metric{"bytes_in_total", "counter", "Bytes given to the stage", [](const Stats& s) { return static_cast<double>(s.bytes_in); }},
+            Metric{"bytes_out_total", "counter", "Bytes output by the stage", [](const Stats& s) { return static_cast<double>(s.bytes_out); }},
+            Metric{"busy_seconds_total", "counter", "Time spent in the filter of the stage, summed over threads", [](const Stats& s) { return s.busy; }},
+            Metric{"wait_seconds_total", "counter", "Time a serial stage spent waiting for a token or for its input", [](const Stats& s) { return s.wait; }},
+            Metric{"utilization", "gauge", "Share of the time the stage could have spent working", [](const Stats& s) { return s.utilization; }},
+    };
+
+    std::array<Stats, nr_pipeline_stages> all_stats;
+    for (PipelineStage stage : pipeline_stages)
+        all_stats[static_cast<int>(stage)] = stats(stage);
+
+    std::string r = fmt::format("# HELP komankondi_dictgen_elapsed_seconds Time since the pipeline started\n"
+                                "# TYPE komankondi_dictgen_elapsed_seconds gauge\n"
+                                "komankondi_dictgen_elapsed_seconds {:.3f}\n",
+                                elapsed());
+    for (const Metric& metric : metrics) {
+        r += fmt::format("# HELP komankondi_dictgen_stage_{} {}\n# TYPE komankondi_dictgen_stage_{} {}\n", metric.name, metric.help, metric.name, metric.type);
+        for (PipelineStage stage : pipeline_stages)
+            r += fmt::format("komankondi_dictgen_stage_{}{{stage=\"{}\"}} {}\n", metric.name, stage, metric.value(all_stats[static_cast<int>(stage)]));
+    }
+    return r;
+}
+
+void PipelineMetrics::save(ZStringView path) const {
+    std::string content = std::string_view{path}.ends_with(".json") ? to_json() : to_prometheus();
+
+    // written aside then renamed, for scrapers to never read a partial file
+    std::string tmp_path = fmt::format("{}.new", path);
+    {
+        File file{tmp_path, File::Mode::truncate};
+        file.write<char>(content);
+    }
+    std::filesystem::rename(tmp_path, path.data());
+}
+
+void PipelineMetrics::log_summary() const {
+    log::info("Pipeline ran for {:.1f}s:", elapsed());
+
+    PipelineStage bottleneck = PipelineStage::fetch;
+    double max_utilization = -1;
+    for (PipelineStage stage : pipeline_stages) {
+        Stats s = stats(stage);
+        log::info("  {:<5} {:>8.1f}s busy ({:>3.0f}%), {:>8.1f}s waiting, {:>9} items, {} in, {} out",
+                  stage, s.busy, s.utilization * 100, s.wait, s.items,
+                  log::Bytes{static_cast<size_t>(s.bytes_in)}, log::Bytes{static_cast<size_t>(s.bytes_out)});
+        if (s.utilization > max_utilization) {
+            max_utilization = s.utilization;
+            bottleneck = stage;
+        }
+    }
+    log::info("Throughput limited by the {} stage", bottleneck);
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+
+/// Filters of the pipeline generating a dictionary, all serial but parse, which is measured for each batch it splits its input in.
+enum class PipelineStage {
+    fetch,
+    gzip,
+    tar,
+    parse,
+    write,
+};
+inline constexpr int nr_pipeline_stages = 5;
+
+std::string_view format_as(PipelineStage stage);
+
+
+/// What each filter of the pipeline did since it started, updated concurrently by the filters.
+struct PipelineMetrics {
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        int64_t items = 0;
+        int64_t bytes_in = 0;
+        int64_t bytes_out = 0;
+        double busy = 0;  ///< seconds spent in the filter, summed over threads
+        double wait = 0;  ///< seconds between calls of a serial filter, waiting for a token or for the previous stage
+        double utilization = 0;  ///< share of the time the stage could have spent working, near 1 for the one limiting throughput
+    };
+
+    /// Measures a call of the filter of a stage, from construction to done.
+    struct Timer {
+        Timer(PipelineMetrics& metrics, PipelineStage stage, int64_t bytes_in = 0);
+
+        void done(int64_t bytes_out = 0);
+
+    private:
+        PipelineMetrics& metrics_;
+        PipelineStage stage_;
+        Clock::time_point start_;
+    };
+
+    PipelineMetrics();
+    PipelineMetrics(const PipelineMetrics&) = delete;
+    PipelineMetrics& operator=(const PipelineMetrics&) = delete;
+
+    Stats stats(PipelineStage stage) const;
+    /// Seconds since the pipeline started.
+    double elapsed() const;
+
+    std::string to_json() const;
+    std::string to_prometheus() const;
+
+    /// Replace the file at path, with json if it ends with .json, else with Prometheus text format.
+    void save(ZStringView path) const;
+
+    /// Log the stats of each stage, and the one that limits throughput.
+    void log_summary() const;
+
+private:
+    struct Counters {
+        std::atomic<int64_t> items = 0;
+        std::atomic<int64_t> bytes_in = 0;
+        std::atomic<int64_t> bytes_out = 0;
+        std::atomic<int64_t> busy_ns = 0;
+        std::atomic<int64_t> wait_ns = 0;
+        Clock::time_point last_end;  ///< only used by serial stages
+    };
+
+    Clock::time_point start_;
+    std::array<Counters, nr_pipeline_stages> stages_;
+};
+
+}  // namespace komankondi::dictgen
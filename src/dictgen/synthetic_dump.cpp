@@ -0,0 +1,251 @@
+#include "synthetic_dump.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <zlib.h>
+
+#include "dictgen/language_spec.hpp"
+#include "utils/exception.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+constexpr std::array<std::string_view, 24> syllables = {"ka", "lo", "mi", "ne", "ra", "tu", "sa", "vo", "pe", "di", "ba", "go",
+                                                        "zi", "fu", "he", "ja", "wo", "ly", "qua", "stra", "ein", "ou", "ch", "é"};
+
+/// Words of the vocabulary definitions are made of.
+std::vector<std::string> make_vocabulary(std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> syllable{0, syllables.size() - 1};
+    std::uniform_int_distribution<int> length{1, 4};
+    std::vector<std::string> r(2000);
+    for (std::string& word : r) {
+        for (int i = length(rng); i > 0; --i)
+            word += syllables[syllable(rng)];
+    }
+    return r;
+}
+
+/// Distinct for each index, by writing it in bijective numeration with syllables as digits.
+std::string article_name(int index) {
+    std::string r;
+    for (int64_t n = index + 1; n > 0; n = (n - 1) / std::ssize(syllables))
+        r += syllables[(n - 1) % syllables.size()];
+    return r;
+}
+
+void append_json_escaped(std::string_view str, std::string& out) {
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (c == '\n') {
+            out += "\\n";
+        }
+        else {
+            out += c;
+        }
+    }
+}
+
+struct ArticleGenerator {
+    const SyntheticDumpOptions& options;
+    std::mt19937 rng{options.seed};
+    std::vector<std::string> vocabulary = make_vocabulary(rng);
+
+    std::string_view random_word() {
+        return vocabulary[std::uniform_int_distribution<size_t>{0, vocabulary.size() - 1}(rng)];
+    }
+
+    bool chance(double probability) {
+        return std::bernoulli_distribution{probability}(rng);
+    }
+
+    int nr_definitions() {
+        double sigma = options.definitions_sigma;
+        std::lognormal_distribution<double> distribution{std::log(options.mean_definitions) - sigma * sigma / 2, sigma};
+        return std::max(1, static_cast<int>(std::lround(distribution(rng))));
+    }
+
+    void append_sentence(std::string& html, int min_words, int max_words) {
+        for (int i = std::uniform_int_distribution<int>{min_words, max_words}(rng); i > 0; --i) {
+            if (chance(0.15)) {
+                std::string_view word = random_word();
+                html += fmt::format(R"(<a rel="mw:WikiLink" href="./{}" title="{}">{}</a>)", word, word, word);
+            }
+            else {
+                html += random_word();
+            }
+            html += i > 1 ? " " : ".";
+        }
+    }
+
+    void append_section(std::string& html, std::string_view name, const SyntheticLanguage& language) {
+        html += fmt::format(R"(<section data-mw-section-id="1"><h2 id="{}">{}</h2>)", language.section_id, language.section_id);
+        html += R"(<h3 id="Etymology">Etymology</h3><p>From )";
+        append_sentence(html, 3, 12);
+        html += "</p>";
+
+        for (int i = std::uniform_int_distribution<int>{1, 3}(rng); i > 0; --i) {
+            const std::string& form_id = language.form_ids[std::uniform_int_distribution<size_t>{0, language.form_ids.size() - 1}(rng)];
+            std::string form_name = form_id;
+            std::replace(form_name.begin(), form_name.end(), '_', ' ');
+            html += fmt::format(R"(<h3 id="{}">{}</h3><p><span class="headword-line"><strong class="Latn headword" lang="{}">{}</strong></span></p><ol>)",
+                                form_id, form_name, language.section_id, name);
+            for (int j = nr_definitions(); j > 0; --j) {
+                html += "<li>";
+                append_sentence(html, 3, 20);
+                if (chance(0.3)) {
+                    html += R"(<dl><dd><i>)";
+                    append_sentence(html, 4, 15);
+                    html += "</i></dd></dl>";
+                }
+                if (chance(0.1)) {
+                    html += R"(<ul><li><b>2001</b>, )";
+                    append_sentence(html, 5, 25);
+                    html += "</li></ul>";
+                }
+                html += "</li>\n";
+            }
+            html += "</ol>";
+            if (chance(0.2)) {
+                html += R"(<h4 id="Synonyms">Synonyms</h4><ul><li>)";
+                html += random_word();
+                html += "</li></ul>";
+            }
+        }
+        html += "</section>";
+    }
+
+    /// Record of an article, with the sections it has set in sections.
+    std::string make_record(int index, std::vector<bool>& sections) {
+        std::string name = article_name(index);
+
+        std::fill(sections.begin(), sections.end(), false);
+        bool any = false;
+        for (size_t i = 0; i < options.languages.size(); ++i)
+            any |= sections[i] = chance(options.languages[i].share);
+        if (!any)
+            sections[std::uniform_int_distribution<size_t>{0, sections.size() - 1}(rng)] = true;
+
+        std::string html = R"(<!DOCTYPE html><html><head><meta charset="utf-8"/></head><body>)";
+        for (size_t i = 0; i < options.languages.size(); ++i) {
+            if (sections[i])
+                append_section(html, name, options.languages[i]);
+        }
+        html += "</body></html>";
+
+        std::string r = fmt::format(R"({{"name":"{}","identifier":{},"date_modified":"2024-01-01T00:00:00Z",)"
+                                    R"("version":{{"identifier":{}}},"url":"https://en.wiktionary.org/wiki/{}",)"
+                                    R"("namespace":{{"identifier":0}},"in_language":{{"identifier":"en"}},"article_body":{{"html":")",
+                                    name, index + 1, index * 7 + 3, name);
+        append_json_escaped(html, r);
+        r += R"(","wikitext":"==)";
+        append_json_escaped(name, r);
+        r += "==\"}}\n";
+        return r;
+    }
+};
+
+void append_tar_member(std::string_view name, std::string_view content, std::vector<std::byte>& tar) {
+    constexpr size_t tar_block_size = 512;
+
+    std::array<char, tar_block_size> header{};
+    auto set_field = [&](size_t offset, std::string_view value) { std::memcpy(header.data() + offset, value.data(), value.size()); };
+    set_field(0, name);
+    set_field(100, "0000644");
+    set_field(108, "0000000");
+    set_field(116, "0000000");
+    set_field(124, fmt::format("{:011o}", content.size()));
+    set_field(136, fmt::format("{:011o}", 1704067200));
+    set_field(148, "        ");
+    header[156] = '0';
+    set_field(257, "ustar");
+    set_field(263, "00");
+    unsigned checksum = 0;
+    for (char c : header)
+        checksum += static_cast<unsigned char>(c);
+    set_field(148, fmt::format("{:06o}", checksum));
+    header[154] = '\0';
+
+    std::span<const std::byte> header_bytes = std::as_bytes(std::span{header});
+    tar.insert(tar.end(), header_bytes.begin(), header_bytes.end());
+    std::span<const std::byte> content_bytes = std::as_bytes(std::span{content});
+    tar.insert(tar.end(), content_bytes.begin(), content_bytes.end());
+    tar.resize((tar.size() + tar_block_size - 1) / tar_block_size * tar_block_size);
+}
+
+std::vector<std::byte> gzip(std::span<const std::byte> data) {
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw Exception{"Could not initialize zlib: {}", stream.msg ? stream.msg : "unknown error"};
+
+    std::vector<std::byte> r(deflateBound(&stream, data.size()));
+    stream.next_in = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<unsigned char*>(r.data());
+    stream.avail_out = r.size();
+    int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+        throw Exception{"Could not compress synthetic dump: zlib error {}", ret};
+    r.resize(stream.total_out);
+    return r;
+}
+
+SyntheticLanguage synthetic_language(const LanguageSpec& language_spec, double share) {
+    return {language_spec.section_id, language_spec.form_ids, share};
+}
+
+}  // namespace
+
+
+std::vector<SyntheticLanguage> default_synthetic_languages() {
+    return {synthetic_language(find_language_spec("english"), 0.4),
+            synthetic_language(find_language_spec("french"), 0.2),
+            {"Dutch", {"Adjective", "Noun", "Verb"}, 0.5}};
+}
+
+SyntheticDump make_synthetic_dump(const SyntheticDumpOptions& options) {
+    if (options.languages.empty())
+        throw Exception{"Could not make synthetic dump: no language"};
+
+    SyntheticDump r;
+    ArticleGenerator generator{options};
+    std::vector<bool> sections(options.languages.size());
+    std::vector<std::byte> tar;
+
+    int index = 0;
+    for (int member = 0; member < options.nr_members; ++member) {
+        std::string json;
+        int end = static_cast<int>(static_cast<int64_t>(options.nr_articles) * (member + 1) / options.nr_members);
+        for (; index < end; ++index) {
+            std::string record = generator.make_record(index, sections);
+            for (size_t i = 0; i < sections.size(); ++i) {
+                if (sections[i])
+                    ++r.nr_articles[options.languages[i].section_id];
+            }
+            json += record;
+            if (generator.chance(options.duplicate_share))
+                json += record;
+        }
+        r.json_size += json.size();
+        append_tar_member(fmt::format("enwiktionary_namespace_0_{}.ndjson", member), json, tar);
+    }
+    tar.resize(tar.size() + 2 * 512);
+
+    r.archive = gzip(tar);
+    return r;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace komankondi::dictgen {
+
+struct SyntheticLanguage {
+    std::string section_id;
+    std::vector<std::string> form_ids;
+    double share = 1;  ///< probability for an article to have a section of this language
+};
+
+/// English, French and Dutch sections, most articles having one or two of them.
+std::vector<SyntheticLanguage> default_synthetic_languages();
+
+struct SyntheticDumpOptions {
+    int nr_articles = 10000;
+    std::vector<SyntheticLanguage> languages = default_synthetic_languages();
+    double mean_definitions = 3;    ///< per form, log-normally distributed to have a few very long articles like real dumps
+    double definitions_sigma = 1;
+    double duplicate_share = 0.01;  ///< records repeated, like in real dumps
+    int nr_members = 4;             ///< ndjson files of the tar
+    uint32_t seed = 1;
+};
+
+struct SyntheticDump {
+    std::vector<std::byte> archive;  ///< gzip of a tar of ndjson files, like *-ENTERPRISE-HTML.json.tar.gz
+    int64_t json_size = 0;
+    std::map<std::string, int, std::less<>> nr_articles;  ///< distinct articles by section id of the languages they have
+};
+
+/// Made-up dump shaped like Wiktionary enterprise html dumps, always the same for the same options.
+SyntheticDump make_synthetic_dump(const SyntheticDumpOptions& options);
+
+}  // namespace komankondi::dictgen
@@ -1,19 +1,58 @@
 #include "tarcat.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <span>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "utils/exception.hpp"
 #include "utils/math.hpp"
 #include "utils/parse.hpp"
 
 namespace komankondi::dictgen {
+namespace {
+
+constexpr size_t tar_block_size = 512;
+
+/// Up to the first null character, fields filling their whole size having none.
+std::string_view header_string(std::span<const std::byte> header, size_t offset, size_t size) {
+    std::string_view r{reinterpret_cast<const char*>(header.data()) + offset, size};
+    return r.substr(0, r.find('\0'));
+}
+
+/// Octal, padded with spaces or nulls, or base-256 for GNU sizes too large for octal.
+int64_t header_number(std::span<const std::byte> header, size_t offset, size_t size) {
+    std::span<const std::byte> field = header.subspan(offset, size);
+    if ((field[0] & std::byte{0x80}) != std::byte{0}) {
+        int64_t r = static_cast<int64_t>(field[0] & std::byte{0x7f});
+        for (std::byte b : field.subspan(1))
+            r = (r << 8) | static_cast<int64_t>(b);
+        return r;
+    }
+
+    std::string_view str = header_string(header, offset, size);
+    size_t begin = str.find_first_not_of(' ');
+    if (begin == std::string_view::npos)
+        return 0;
+    str = str.substr(begin);
+    return parse<int64_t>(str.substr(0, str.find(' ')), 8);
+}
+
+}  // namespace
+
 
 bool TarCat::finished() const {
     return remaining_ == 0 && buf_.empty();
 }
 
+const std::vector<TarCat::Member>& TarCat::members() const {
+    return members_;
+}
+
 std::vector<std::byte> TarCat::operator()(std::span<const std::byte> data) {
     std::vector<std::byte> r;
     (*this)(data, r);
@@ -21,109 +60,137 @@ std::vector<std::byte> TarCat::operator()(std::span<const std::byte> data) {
 }
 
 void TarCat::operator()(std::span<const std::byte> data, std::vector<std::byte>& out) {
-    constexpr int tar_block_size = 512;
-
-    out.reserve(out.size() + data.size());
+    views_.clear();
+    views(data, views_);
+    for (const View& view : views_)
+        out.insert(out.end(), view.data.begin(), view.data.end());
+}
 
-    int offset = 0;
-    while (offset < std::ssize(data)) {
-        int unparsed_size = data.size() - offset;
-        if (unparsed_size <= remaining_) {
-            remaining_ -= unparsed_size;
-            out.insert(out.end(), data.begin() + offset, data.end());
-            break;
+void TarCat::views(std::span<const std::byte> data, std::vector<View>& out) {
+    while (!data.empty()) {
+        if (remaining_ > 0) {
+            size_t size = std::min<uint64_t>(remaining_, data.size());
+            remaining_ -= size;
+            if (content_ == Content::file)
+                out.push_back({data.first(size), static_cast<int>(members_.size()) - 1, remaining_ == 0});
+            else if (content_ != Content::skipped)
+                metadata_.insert(metadata_.end(), data.begin(), data.begin() + size);
+            if (remaining_ == 0 && content_ != Content::file)
+                parse_metadata();
+            data = data.subspan(size);
+            continue;
         }
-
-        out.insert(out.end(), data.begin() + offset, data.begin() + offset + remaining_);
-        offset += remaining_;
-        unparsed_size -= remaining_;
-        remaining_ = 0;
-
-        if (unparsed_size <= padding_) {
-            padding_ -= unparsed_size;
-            break;
+        if (padding_ > 0) {
+            size_t size = std::min<uint64_t>(padding_, data.size());
+            padding_ -= size;
+            data = data.subspan(size);
+            continue;
         }
-        offset += padding_;
-        unparsed_size -= remaining_;
-        padding_ = 0;
 
-        if (buf_.size() + unparsed_size < tar_block_size) {
-            buf_.insert(buf_.end(), data.begin() + offset, data.end());
-            break;
+        std::span<const std::byte> header;
+        if (buf_.empty() && data.size() >= tar_block_size) {
+            header = data.first(tar_block_size);
+            data = data.subspan(tar_block_size);
         }
-        int header_size_in_data = tar_block_size - buf_.size();
-        std::span<const std::byte> header = [&]() -> std::span<const std::byte> {
-            if (buf_.empty())
-                return data.subspan(offset, tar_block_size);
-            buf_.insert(buf_.end(), data.begin() + offset, data.begin() + offset + header_size_in_data);
-            return buf_;
-        }();
-
-        std::string_view file_size{reinterpret_cast<const char*>(header.data()) + 124, 11};
-        if (file_size[0] != '\0') {
-            remaining_ = parse<int64_t>(file_size, 8);
-            padding_ = ceil(remaining_, tar_block_size) - remaining_;
+        else {
+            size_t size = std::min(tar_block_size - buf_.size(), data.size());
+            buf_.insert(buf_.end(), data.begin(), data.begin() + size);
+            data = data.subspan(size);
+            if (buf_.size() < tar_block_size)
+                break;
+            header = buf_;
         }
+        parse_header(header);
         buf_.clear();
 
-        offset += header_size_in_data;
+        if (content_ == Content::file && remaining_ == 0)
+            out.push_back({{}, static_cast<int>(members_.size()) - 1, true});
     }
 }
 
-void TarCat::inplace(std::vector<std::byte>& data) {
-    constexpr int tar_block_size = 512;
-
-    int content_size = 0;
-    int offset = 0;
-    while (offset < std::ssize(data)) {
-        int unparsed_size = data.size() - offset;
-        if (unparsed_size <= remaining_) {
-            remaining_ -= unparsed_size;
-            if (offset == 0)
-                return;
-            std::copy(data.begin() + offset, data.end(), data.begin() + content_size);
-            content_size += unparsed_size;
-            break;
-        }
+void TarCat::parse_header(std::span<const std::byte> header) {
+    // archives end with blocks of zeros
+    if (std::all_of(header.begin(), header.end(), [](std::byte b) { return b == std::byte{0}; })) {
+        content_ = Content::skipped;
+        return;
+    }
 
-        if (offset != 0)
-            std::copy_n(data.begin() + offset, remaining_, data.begin() + content_size);
-        content_size += remaining_;
-        offset += remaining_;
-        unparsed_size -= remaining_;
-        remaining_ = 0;
+    remaining_ = header_number(header, 124, 12);
+    padding_ = ceil(remaining_, int64_t{tar_block_size}) - remaining_;
+
+    char type = static_cast<char>(header[156]);
+    switch (type) {
+    case '\0':
+    case '0':
+    case '7': {
+        content_ = Content::file;
+        std::string name{header_string(header, 0, 100)};
+        // ustar splits long names in a prefix and a name
+        if (std::string_view prefix = header_string(header, 345, 155);
+            header_string(header, 257, 6) == "ustar" && !prefix.empty())
+            name = std::string{prefix} + "/" + name;
+        if (next_size_)
+            remaining_ = *next_size_;
+        padding_ = ceil(remaining_, int64_t{tar_block_size}) - remaining_;
+        members_.push_back({next_name_.value_or(std::move(name)), remaining_});
+        next_name_.reset();
+        next_size_.reset();
+        break;
+    }
+    case 'L':
+        content_ = Content::long_name;
+        break;
+    case 'x':
+        content_ = Content::pax;
+        break;
+    case 'K':
+    case 'g':
+        // a long link name or global pax headers, that leave the metadata of the next member to it
+        content_ = Content::skipped;
+        break;
+    default:
+        // directories, links, ...
+        content_ = Content::skipped;
+        next_name_.reset();
+        next_size_.reset();
+        break;
+    }
 
-        if (unparsed_size <= padding_) {
-            padding_ -= unparsed_size;
-            break;
-        }
-        offset += padding_;
-        unparsed_size -= remaining_;
-        padding_ = 0;
+    metadata_.clear();
+    if (remaining_ == 0 && content_ != Content::file && content_ != Content::skipped)
+        parse_metadata();
+}
 
-        if (buf_.size() + unparsed_size < tar_block_size) {
-            buf_.insert(buf_.end(), data.begin() + offset, data.end());
-            break;
-        }
-        int header_size_in_data = tar_block_size - buf_.size();
-        std::span<const std::byte> header = [&]() {
-            if (buf_.empty())
-                return std::span{data}.subspan(offset, tar_block_size);
-            buf_.insert(buf_.end(), data.begin() + offset, data.begin() + offset + header_size_in_data);
-            return std::span{buf_};
-        }();
-
-        std::string_view file_size{reinterpret_cast<const char*>(header.data()) + 124, 11};
-        if (file_size[0] != '\0') {
-            remaining_ = parse<int64_t>(file_size, 8);
-            padding_ = ceil(remaining_, tar_block_size) - remaining_;
+void TarCat::parse_metadata() {
+    std::string_view content{reinterpret_cast<const char*>(metadata_.data()), metadata_.size()};
+    if (content_ == Content::long_name) {
+        next_name_ = content.substr(0, content.find('\0'));
+    }
+    else if (content_ == Content::pax) {
+        // records of "<length> <key>=<value>\n", length counting the whole record
+        while (!content.empty()) {
+            size_t space = content.find(' ');
+            if (space == std::string_view::npos)
+                throw Exception{"Could not parse pax header: record without length"};
+            size_t length = parse<size_t>(content.substr(0, space));
+            if (length <= space + 1 || length > content.size())
+                throw Exception{"Could not parse pax header: invalid record length {}", length};
+            std::string_view record = content.substr(space + 1, length - space - 2);
+            content = content.substr(length);
+
+            size_t equal = record.find('=');
+            if (equal == std::string_view::npos)
+                throw Exception{"Could not parse pax header: record without value"};
+            std::string_view key = record.substr(0, equal);
+            std::string_view value = record.substr(equal + 1);
+            if (key == "path")
+                next_name_ = value;
+            else if (key == "size")
+                next_size_ = parse<int64_t>(value);
         }
-        buf_.clear();
-
-        offset += header_size_in_data;
     }
-
-    data.resize(content_size);
+    metadata_.clear();
+    content_ = Content::skipped;
 }
 
 }  // namespace komankondi::dictgen
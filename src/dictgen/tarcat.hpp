@@ -1,22 +1,60 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <span>
+#include <string>
 #include <vector>
 
 namespace komankondi::dictgen {
 
+/// Content of the files of a tar archive given in consecutive pieces, in ustar, GNU or pax format.
 struct TarCat {
+    struct Member {
+        std::string name;
+        int64_t size = 0;
+    };
+
+    /// Part of the content of a file.
+    struct View {
+        std::span<const std::byte> data;
+        int member = 0;    ///< index in members()
+        bool end = false;  ///< whether it is the last part of the member, empty when the member is
+    };
+
     bool finished() const;
 
+    /// Files found so far.
+    const std::vector<Member>& members() const;
+
+    /// Concatenated content of the files.
     std::vector<std::byte> operator()(std::span<const std::byte> data);
     void operator()(std::span<const std::byte> data, std::vector<std::byte>& out);
-    void inplace(std::vector<std::byte>& data);
+
+    /// Same as operator(), but appends the parts of data that are file content instead of copying them.
+    /// Only headers, and contents of GNU long names and pax extended headers, are buffered.
+    void views(std::span<const std::byte> data, std::vector<View>& out);
 
 private:
+    enum class Content {
+        file,
+        long_name,
+        pax,
+        skipped,
+    };
+
     int64_t remaining_ = 0;
-    int padding_ = 0;
+    int64_t padding_ = 0;
+    Content content_ = Content::skipped;
     std::vector<std::byte> buf_;
+    std::vector<std::byte> metadata_;
+    std::optional<std::string> next_name_;  ///< set by GNU long names and pax headers for the next file
+    std::optional<int64_t> next_size_;
+    std::vector<Member> members_;
+    std::vector<View> views_;
+
+    void parse_header(std::span<const std::byte> header);
+    void parse_metadata();
 };
 
 }  // namespace komankondi::dictgen
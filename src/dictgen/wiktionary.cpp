@@ -1,71 +1,188 @@
 #include "wiktionary.hpp"
 
 #include <algorithm>
-#include <atomic>
 #include <chrono>
-#include <exception>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
-#include <boost/json/parse.hpp>
-#include <boost/json/value.hpp>
 #include <boost/regex.hpp>
 #include <fmt/core.h>
 #include <httplib.h>
 #include <range/v3/algorithm/max.hpp>
 #include <range/v3/view/subrange.hpp>
 #include <range/v3/view/transform.hpp>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
 
+#include "dict/reader.hpp"
+#include "dict/word.hpp"
 #include "dict/writer.hpp"
+#include "dictgen/article_hashes.hpp"
 #include "dictgen/cache.hpp"
 #include "dictgen/downloader.hpp"
 #include "dictgen/gzip.hpp"
+#include "dictgen/html.hpp"
+#include "dictgen/json_extract.hpp"
+#include "dictgen/language_spec.hpp"
+#include "dictgen/line_splitter.hpp"
+#include "dictgen/pipeline_metrics.hpp"
 #include "dictgen/tarcat.hpp"
+#include "dictgen/word_cache.hpp"
+#include "utils/buffer_pool.hpp"
 #include "utils/config.hpp"
 #include "utils/exception.hpp"
-#include "utils/find_last.hpp"
-#include "utils/iequal.hpp"
+#include "utils/hasher.hpp"
 #include "utils/log.hpp"
 #include "utils/path.hpp"
 #include "utils/signal.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dictgen {
+namespace {
+
+/// Lines of the files of the dump, from a piece of it.
+struct Chunk {
+    BufferPool::Buffer data;
+    LineSplitter::Lines lines;
+
+    int64_t size() const {
+        int64_t r = 0;
+        for (std::string_view line : lines.lines)
+            r += line.size();
+        return r;
+    }
+};
+
+struct ExtractedArticles {
+    std::vector<dict::Word> words;
+    std::vector<ArticleHash> hashes;
+    int nr_unchanged = 0;
+};
+
+std::optional<std::string> describe_article(std::string_view html, const LanguageSpec& language_spec) {
+    std::vector<ArticleForm> forms = parse_article(html, language_spec);
+    if (forms.empty())
+        return {};
+
+    std::string r;
+    for (const ArticleForm& form : forms) {
+        r += form.name;
+        r += ":\n";
+
+        for (std::string_view definition_html : form.definitions) {
+            r += "- ";
+            append_html_text(definition_html, r);
+            r += "\n";
+        }
 
-LanguageSpec find_language_spec(std::string_view query) {
-    if (iequal(query, std::string_view{"english"}.substr(0, query.length()))) {
-        return {"English",
-                "en",
-                boost::regex{R"(<h2 id="English".*?(?=<h2 |\z))"},
-                boost::regex{R"(<h3 id="(?:)"
-                             "Adjective|Adverb|Conjunction|Determiner|Interjection|Noun|Phrase|Postposition|Preposition|Pronoun|Proverb|Verb"
-                             R"().*?>(?:<.*?>)*(.+?)<.*?(?=<h\d+ |\z))"},
-                boost::regex{R"(<li\b.*?>(.*?)(?:\n<([du]l)\b.*?</\g{-1}>)*</li>)"}};
+        r += "\n";
     }
+    return r;
+}
+
+/// Parse cost of an article on top of that of its bytes, about the time taken by a kilobyte of html.
+constexpr int64_t article_cost = 1024;
+/// Below that, splitting work costs more than it saves.
+constexpr int64_t min_batch_cost = 64 * 1024;
+
+ExtractedArticles extract_batch(std::span<const std::string_view> lines, const LanguageSpec& language_spec, const ArticleHashes* previous_hashes,
+                                tbb::enumerable_thread_specific<std::unique_ptr<dict::Reader>>& previous_dicts) {
+    ExtractedArticles r;
+    JsonStorage storage;
+    Hasher hasher{"sha256"};
+    for (auto [word, html] : extract_articles(lines, storage)) {
+        ArticleHash hash{hash64(hasher, word), hash64(hasher, html)};
+
+        std::optional<std::string> description;
+        const ArticleHash* previous = previous_hashes ? previous_hashes->find(hash.name) : nullptr;
+        if (previous && previous->content == hash.content) {
+            if (!previous->has_word) {
+                r.hashes.push_back(hash);
+                continue;
+            }
+            description = previous_dicts.local()->find_description(word);
+            if (description)
+                ++r.nr_unchanged;
+        }
+        if (!description) {
+            log::trace("Parsing {}", word);
+            description = describe_article(html, language_spec);
+        }
 
-    if (iequal(query, std::string_view{"french"}.substr(0, query.length()))) {
-        return {"French",
-                "fr",
-                boost::regex{R"(<h2 id="Français".*?(?=<h2 |\z))"},
-                boost::regex{R"(<h3 id="(?:)"
-                             "Adjectif|Adverbe|Conjonction|Interjection|Locution|Nom_commun|Onomatopée|Postposition|Préposition|Pronom|Proverbe|Verbe"
-                             R"().*?>(?:<.*?>)*(.+?)<.*?(?=<h\d+ |\z))"},
-                boost::regex{R"(<li\b.*?>(.*?)(?:\n<ul\b.*?</ul>)?</li>)"}};
+        hash.has_word = description.has_value();
+        r.hashes.push_back(hash);
+        if (description)
+            r.words.push_back({std::string{word}, std::move(*description)});
     }
+    return r;
+}
 
-    throw Exception{"Could not find a language that starts with {}", query};
+/// Concatenate in order.
+ExtractedArticles merge(std::vector<ExtractedArticles>&& batches) {
+    if (batches.size() == 1)
+        return std::move(batches.front());
+
+    ExtractedArticles r;
+    size_t nr_words = 0;
+    size_t nr_hashes = 0;
+    for (const ExtractedArticles& batch : batches) {
+        nr_words += batch.words.size();
+        nr_hashes += batch.hashes.size();
+    }
+    r.words.reserve(nr_words);
+    r.hashes.reserve(nr_hashes);
+    for (ExtractedArticles& batch : batches) {
+        std::move(batch.words.begin(), batch.words.end(), std::back_inserter(r.words));
+        r.hashes.insert(r.hashes.end(), batch.hashes.begin(), batch.hashes.end());
+        r.nr_unchanged += batch.nr_unchanged;
+    }
+    return r;
 }
 
-void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, bool cache) {
+void replay_word_cache(ZStringView word_cache_path, ZStringView path, const GenerateOptions& options, ZStringView hashes_path) {
+    log::info("Found cache of extracted words");
+
+    // the dictionary is about to no longer match the hashes
+    std::filesystem::remove(hashes_path.data());
+
+    WordCacheReader reader{word_cache_path};
+    dict::Writer dict{path, options.format, options.full_text, options.near_words};
+    size_t total_words = 0;
+    for (int i = 0; i < reader.nr_frames(); ++i) {
+        if (terminating())
+            return;
+        total_words += dict.add_words(reader.read_frame(i));
+    }
+
+    dict.save();
+    log::info("Successfully saved new dictionary with {} words", total_words);
+}
+
+}  // namespace
+
+
+std::string dump_path(std::string_view code, std::string_view date) {
+    return fmt::format("{}{}/{}wiktionary-NS0-{}-ENTERPRISE-HTML.json.tar.gz", dump_runs_path, date, code, date);
+}
+
+void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, const GenerateOptions& options) {
     log::info("Generating {} dictionary from Wiktionary", language_spec.name);
 
-    std::string host = "dumps.wikimedia.org";
-    httplib::SSLClient http{host};
+    const std::string& origin = options.dump_host;
+    httplib::Client http{origin};
 
-    httplib::Result index_res = http.Get("/other/enterprise_html/runs/");
+    httplib::Result index_res = http.Get(std::string{dump_runs_path});
     if (!index_res)
         throw Exception{"Could not get dumps index: {}", httplib::to_string(index_res.error())};
     if (index_res->status != 200)
@@ -81,30 +198,72 @@ void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, bo
     std::string dump_date = ranges::max(dump_dates);
     log::info("Using latest dump from {}", dump_date);
 
-    std::string dump_url = fmt::format("/other/enterprise_html/runs/{}/{}wiktionary-NS0-{}-ENTERPRISE-HTML.json.tar.gz",
-                                       dump_date, language_spec.code, dump_date);
+    std::string dump_url = dump_path(language_spec.code, dump_date);
+
+    // words only depend on the dump and on how they are extracted from it
+    std::string spec_hash = hash(language_spec);
+    std::string hashes_path = fmt::format("{}.hashes", path);
+    std::optional<WordCacheWriter> word_cache;
+    if (options.cache) {
+        std::string word_cache_path = fmt::format("{}/{}_{}_{}.words", get_cache_directory(), language_spec.code, dump_date, spec_hash);
+        if (std::filesystem::exists(word_cache_path)) {
+            replay_word_cache(word_cache_path, path, options, hashes_path);
+            return;
+        }
+        word_cache.emplace(word_cache_path);
+    }
+
+    std::optional<ArticleHashes> previous_hashes;
+    if (options.incremental && std::filesystem::exists(path.data())) {
+        previous_hashes = ArticleHashes::load(hashes_path, spec_hash);
+        if (previous_hashes)
+            log::info("Found hashes of {} articles of the previous dictionary", previous_hashes->size());
+    }
+    tbb::enumerable_thread_specific<std::unique_ptr<dict::Reader>> previous_dicts{[&] { return std::make_unique<dict::Reader>(path); }};
+    ArticleHashes hashes;
 
+    BufferPool pool;
     std::optional<File> cached_file;
     std::optional<Downloader> downloader;
     Cacher cacher;
-    std::function<std::optional<std::vector<std::byte>>()> fetch;
-    if (cache) {
+    std::function<std::optional<BufferPool::Buffer>()> fetch;
+    if (options.cache) {
         std::string cache_path = fmt::format("{}/{}_{}.tgz", get_cache_directory(), language_spec.code, dump_date);
         cached_file = try_load_cache(cache_path);
         if (cached_file) {
-            fetch = [&cached_file = *cached_file]() -> std::optional<std::vector<std::byte>> {
+            fetch = [&cached_file = *cached_file, &pool]() -> std::optional<BufferPool::Buffer> {
                 if (cached_file.eof())
                     return {};
-                return cached_file.read();
+                BufferPool::Buffer r = pool.get(default_buffer_size);
+                cached_file.read(*r);
+                // eof is only known after a read past the end, an empty chunk would flush mid-stream
+                if (r->empty())
+                    return {};
+                return r;
             };
         }
         else {
-            downloader.emplace(host, dump_url);
             cacher = {cache_path};
-            fetch = [&downloader, &cacher] {
-                std::optional<std::vector<std::byte>> r = downloader->read();
+            downloader.emplace(origin, dump_url, pool, cacher.kept_size(), cacher.kept_validator(), options.nr_connections);
+            int64_t kept_size = downloader->headers().offset;
+            cacher.begin(kept_size, downloader->headers().validator);
+            if (kept_size > 0)
+                cached_file = cacher.read_kept();
+
+            // the data kept from a previous run goes first through the pipeline, then the rest of the download
+            fetch = [&downloader, &cacher, &cached_file, &pool, kept_size]() mutable -> std::optional<BufferPool::Buffer> {
+                if (kept_size > 0) {
+                    BufferPool::Buffer r = pool.get(default_buffer_size);
+                    cached_file->read(*r, std::min<int64_t>(kept_size, default_buffer_size));
+                    if (r->empty())
+                        throw Exception{"Could not read temporary cache: file got truncated"};
+                    kept_size -= r->size();
+                    return r;
+                }
+
+                std::optional<BufferPool::Buffer> r = downloader->read();
                 if (r) {
-                    cacher.write<std::byte>(*r);
+                    cacher.write<std::byte>(**r);
                 }
                 else {
                     cacher.save();
@@ -114,151 +273,141 @@ void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, bo
         }
     }
     else {
-        downloader.emplace(host, dump_url);
+        downloader.emplace(origin, dump_url, pool, 0, "", options.nr_connections);
         fetch = [&downloader] { return downloader->read(); };
     }
 
 
-    GzipDecompressor unzip;
+    bool fetched_all = false;
+    GzipDecompressor unzip{options.gzip_backend};
     TarCat tarcat;
-    std::vector<std::byte> partial_line;
-    dict::Writer dict{path};
-
-    boost::regex re_tag{"<.*?>"};
+    std::vector<TarCat::View> tar_views;
+    int member = -1;
+    LineSplitter line_splitter{pool};
+    dict::Writer dict{path, options.format, options.full_text, options.near_words};
 
-    std::atomic<size_t> total_bytes = 0;
-    std::atomic<size_t> total_bytes_json = 0;
+    PipelineMetrics metrics;
     size_t total_words = 0;
+    size_t total_unchanged = 0;
     std::chrono::steady_clock::time_point last_stat_time = std::chrono::steady_clock::now();
-    size_t last_stat_bytes = 0;
-    size_t last_stat_bytes_json = 0;
+    PipelineMetrics::Stats last_stat_gzip;
+    PipelineMetrics::Stats last_stat_parse;
     size_t last_stat_words = 0;
 
     tbb::parallel_pipeline(default_parallel_queue_size(),
-                           tbb::make_filter<void, std::vector<std::byte>>(
+                           tbb::make_filter<void, BufferPool::Buffer>(
                                    tbb::filter_mode::serial_in_order,
-                                   [&fetch](tbb::flow_control& fc) {
-                                       std::optional<std::vector<std::byte>> data;
+                                   [&fetch, &fetched_all, &pool, &metrics](tbb::flow_control& fc) {
+                                       // fetch must not be called again once it ran out of data
+                                       if (fetched_all) {
+                                           fc.stop();
+                                           return pool.get();
+                                       }
+                                       PipelineMetrics::Timer timer{metrics, PipelineStage::fetch};
+                                       std::optional<BufferPool::Buffer> data;
                                        if (!terminating())
                                            data = fetch();
                                        if (!data) {
-                                           fc.stop();
-                                           return std::vector<std::byte>{};
+                                           // send an empty chunk before stopping, to flush data buffered by next stages
+                                           fetched_all = true;
+                                           timer.done();
+                                           return pool.get();
                                        }
+                                       timer.done((*data)->size());
                                        return std::move(*data);
                                    })
-                                   & tbb::make_filter<std::vector<std::byte>, std::vector<std::byte>>(
+                                   & tbb::make_filter<BufferPool::Buffer, BufferPool::Buffer>(
                                            tbb::filter_mode::serial_in_order,
-                                           [&unzip, &total_bytes](std::vector<std::byte>&& data) {
-                                               total_bytes.fetch_add(data.size(), std::memory_order::relaxed);
-                                               return unzip(data);
+                                           [&unzip, &pool, &metrics](BufferPool::Buffer&& data) {
+                                               PipelineMetrics::Timer timer{metrics, PipelineStage::gzip, std::ssize(*data)};
+                                               BufferPool::Buffer r = pool.get(default_buffer_size);
+                                               unzip(*data, *r);
+                                               timer.done(r->size());
+                                               return r;
                                            })
-                                   & tbb::make_filter<std::vector<std::byte>, std::vector<std::byte>>(
+                                   & tbb::make_filter<BufferPool::Buffer, Chunk>(
                                            tbb::filter_mode::serial_in_order,
-                                           [&tarcat, &partial_line](std::vector<std::byte>&& data) {
-                                               std::vector<std::byte> r = std::move(partial_line);
-                                               tarcat(data, r);
-                                               auto it = find_last(r, std::byte{'\n'});
-                                               if (it == r.end()) {
-                                                   partial_line = std::move(r);
-                                                   return std::vector<std::byte>{};
+                                           [&tarcat, &tar_views, &member, &line_splitter, &metrics](BufferPool::Buffer&& data) {
+                                               PipelineMetrics::Timer timer{metrics, PipelineStage::tar, std::ssize(*data)};
+                                               // lines point into the decompressed data, that moves along with them
+                                               Chunk r{std::move(data), {}};
+                                               tar_views.clear();
+                                               tarcat.views(*r.data, tar_views);
+                                               for (const TarCat::View& view : tar_views) {
+                                                   if (view.member != member) {
+                                                       member = view.member;
+                                                       const TarCat::Member& m = tarcat.members()[member];
+                                                       log::debug("Extracting {} ({})", m.name, log::Bytes{static_cast<size_t>(m.size)});
+                                                   }
+                                                   line_splitter(view.data, r.lines);
+                                                   // members are independent, none of their lines straddles another one
+                                                   if (view.end)
+                                                       line_splitter.finish(r.lines);
                                                }
-                                               partial_line.assign(it + 1, r.end());
-                                               r.erase(it + 1, r.end());
+                                               timer.done(r.size());
                                                return r;
                                            })
-                                   & tbb::make_filter<std::vector<std::byte>, std::vector<std::pair<std::string, std::string>>>(
+                                   & tbb::make_filter<Chunk, ExtractedArticles>(
                                            tbb::filter_mode::parallel,
-                                           [&language_spec, &re_tag, &total_bytes_json](std::vector<std::byte>&& data) {
-                                               total_bytes_json.fetch_add(data.size(), std::memory_order::relaxed);
-                                               std::vector<std::pair<std::string, std::string>> r;
-                                               std::string_view remaining{reinterpret_cast<char*>(data.data()), data.size()};
-                                               while (!remaining.empty()) {
-                                                   int size = remaining.find('\n');
-                                                   std::string_view line = remaining.substr(0, size);
-                                                   remaining = remaining.substr(size + 1);
-
-                                                   boost::json::value json = boost::json::parse(line);
-                                                   std::string_view word = json.at("name").as_string();
-                                                   std::string_view html = json.at("article_body").at("html").as_string();
-
-                                                   log::trace("Parsing {}", word);
-
-                                                   using match_sv = boost::match_results<std::string_view::iterator>;
-                                                   using regex_iterator_sv = boost::regex_iterator<std::string_view::iterator>;
-
-                                                   match_sv lang_section_match;
-                                                   if (!boost::regex_search(html.begin(), html.end(), lang_section_match, language_spec.re_language))
-                                                       continue;
-                                                   std::string_view lang_html{lang_section_match[0].begin(), lang_section_match[0].end()};
-
-                                                   if (lang_html.find(R"("./Modèle:mercihabitants")") != std::string_view::npos)
-                                                       continue;
-
-                                                   ranges::subrange forms{regex_iterator_sv{lang_html.begin(), lang_html.end(), language_spec.re_form},
-                                                                          regex_iterator_sv{}};
-                                                   if (forms.empty())
-                                                       continue;
-
-                                                   std::string description;
-                                                   for (const match_sv& form_match : forms) {
-                                                       std::string_view form_name{form_match[1].begin(), form_match[1].end()};
-                                                       std::string_view form_html{form_match[0].begin(), form_match[0].end()};
-
-                                                       description += form_name;
-                                                       description += ":\n";
-
-                                                       ranges::subrange definitions{regex_iterator_sv{form_html.begin(), form_html.end(), language_spec.re_definition},
-                                                                                    regex_iterator_sv{}};
-                                                       for (const match_sv& definition_match : definitions) {
-                                                           std::string_view definition_html{definition_match[1].begin(), definition_match[1].end()};
-
-                                                           std::string definition_text = boost::regex_replace(std::string{definition_html}, re_tag, "");
-
-                                                           description += "- ";
-                                                           description += definition_text;
-                                                           description += "\n";
-                                                       }
-
-                                                       description += "\n";
-                                                   }
-
-                                                   r.emplace_back(word, description);
-                                               }
-                                               return r;
+                                           [&language_spec, &previous_hashes, &previous_dicts, &metrics](Chunk&& chunk) {
+                                               // a chunk may hold a single huge article or hundreds of small ones, splitting it
+                                               // lets idle threads steal part of the work instead of waiting for the next chunk
+                                               int64_t batch_cost = std::max<int64_t>(min_batch_cost, chunk.size() / (4 * tbb::this_task_arena::max_concurrency()));
+                                               std::vector<std::span<const std::string_view>> batches = split_lines(chunk.lines.lines, batch_cost, article_cost);
+                                               std::vector<ExtractedArticles> extracted(batches.size());
+                                               tbb::parallel_for(0, static_cast<int>(batches.size()), [&](int i) {
+                                                   int64_t batch_size = 0;
+                                                   for (std::string_view line : batches[i])
+                                                       batch_size += line.size();
+                                                   PipelineMetrics::Timer timer{metrics, PipelineStage::parse, batch_size};
+                                                   extracted[i] = extract_batch(batches[i], language_spec, previous_hashes ? &*previous_hashes : nullptr, previous_dicts);
+                                                   int64_t words_size = 0;
+                                                   for (const dict::Word& word : extracted[i].words)
+                                                       words_size += word.word.size() + word.description.size();
+                                                   timer.done(words_size);
+                                               });
+                                               return merge(std::move(extracted));
                                            })
-                                   & tbb::make_filter<std::vector<std::pair<std::string, std::string>>, void>(
-                                           tbb::filter_mode::serial_out_of_order,
-                                           [&dict,
-                                            &total_bytes, &total_bytes_json, &total_words,
-                                            &last_stat_time, &last_stat_bytes, &last_stat_bytes_json, &last_stat_words](
-                                                   const std::vector<std::pair<std::string, std::string>>& words) {
-                                               for (const auto& [word, description] : words) {
-                                                   try {
-                                                       dict.add_word(word, description);
-                                                       ++total_words;
-                                                   }
-                                                   catch (const std::exception& ex) {
-                                                       // dumps currently have duplicates: https://phabricator.wikimedia.org/T305407
-                                                       log::debug("Could not add word {}: {}", word, ex.what());
-                                                   }
-                                               }
+                                   & tbb::make_filter<ExtractedArticles, void>(
+                                           // in order, for a same dump to always give the same dictionary
+                                           tbb::filter_mode::serial_in_order,
+                                           [&dict, &word_cache, &hashes, &pool, &metrics, &options, &total_words, &total_unchanged,
+                                            &last_stat_time, &last_stat_gzip, &last_stat_parse, &last_stat_words](
+                                                   const ExtractedArticles& articles) {
+                                               PipelineMetrics::Timer timer{metrics, PipelineStage::write};
+                                               // dumps currently have duplicates, that are skipped: https://phabricator.wikimedia.org/T305407
+                                               total_words += dict.add_words(articles.words);
+                                               total_unchanged += articles.nr_unchanged;
+                                               if (word_cache)
+                                                   word_cache->add_words(articles.words);
+                                               for (const ArticleHash& hash : articles.hashes)
+                                                   hashes.add(hash);
+                                               timer.done();
 
                                                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
                                                if (now > last_stat_time + std::chrono::seconds{2}) {
-                                                   size_t total_bytes_now = total_bytes.load(std::memory_order::relaxed);
-                                                   size_t total_bytes_json_now = total_bytes_json.load(std::memory_order::relaxed);
+                                                   PipelineMetrics::Stats gzip = metrics.stats(PipelineStage::gzip);
+                                                   PipelineMetrics::Stats parse = metrics.stats(PipelineStage::parse);
                                                    double delta = std::chrono::duration<double>(now - last_stat_time).count();
-                                                   log::info("{} ({}/s) -> {} ({}/s) -> {} words ({}/s)",
-                                                             log::Bytes{total_bytes_now}, log::Bytes{(total_bytes_now - last_stat_bytes) / delta},
-                                                             log::Bytes{total_bytes_json_now}, log::Bytes{(total_bytes_json_now - last_stat_bytes_json) / delta},
-                                                             total_words, static_cast<int>((total_words - last_stat_words) / delta));
+                                                   BufferPool::Stats buffers = pool.stats();
+                                                   log::info("{} ({}/s) -> {} ({}/s) -> {} words ({}/s), {} buffers allocated ({} in use, peak {})",
+                                                             log::Bytes{static_cast<size_t>(gzip.bytes_in)},
+                                                             log::Bytes{(gzip.bytes_in - last_stat_gzip.bytes_in) / delta},
+                                                             log::Bytes{static_cast<size_t>(parse.bytes_in)},
+                                                             log::Bytes{(parse.bytes_in - last_stat_parse.bytes_in) / delta},
+                                                             total_words, static_cast<int>((total_words - last_stat_words) / delta),
+                                                             buffers.allocated, buffers.in_use, buffers.peak_in_use);
+                                                   if (!options.metrics_path.empty())
+                                                       metrics.save(options.metrics_path);
                                                    last_stat_time = now;
-                                                   last_stat_bytes = total_bytes_now;
-                                                   last_stat_bytes_json = total_bytes_json_now;
+                                                   last_stat_gzip = gzip;
+                                                   last_stat_parse = parse;
                                                    last_stat_words = total_words;
                                                }
                                            }));
+    if (!options.metrics_path.empty())
+        metrics.save(options.metrics_path);
+    metrics.log_summary();
     if (terminating())
         return;
 
@@ -266,11 +415,15 @@ void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, bo
         throw Exception{"Data ends with an unfinished gzip stream"};
     if (!tarcat.finished())
         throw Exception{"Data ends with an unfinished tar file"};
-    if (!partial_line.empty())
+    if (!line_splitter.finished())
         throw Exception{"Data ends with a partial line"};
 
+    std::filesystem::remove(hashes_path);
     dict.save();
-    log::info("Successfully saved new dictionary with {} words", total_words);
+    log::info("Successfully saved new dictionary with {} words, {} unchanged", total_words, total_unchanged);
+    hashes.save(hashes_path, spec_hash);
+    if (word_cache)
+        word_cache->save();
 }
 
 }  // namespace komankondi::dictgen
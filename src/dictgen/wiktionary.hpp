@@ -3,22 +3,32 @@
 #include <string>
 #include <string_view>
 
-#include <boost/regex.hpp>
-
+#include "dict/format.hpp"
+#include "dictgen/gzip.hpp"
+#include "dictgen/language_spec.hpp"
 #include "utils/zstring_view.hpp"
 
 namespace komankondi::dictgen {
 
-struct LanguageSpec {
-    std::string name;
-    std::string code;
+/// Path of the page listing the runs of enterprise html dumps, a subdirectory per date.
+inline constexpr std::string_view dump_runs_path = "/other/enterprise_html/runs/";
+
+/// Path of the dump of the Wiktionary of the language code, from the run of date (YYYYMMDD).
+std::string dump_path(std::string_view code, std::string_view date);
+
 
-    boost::regex re_language;
-    boost::regex re_form;
-    boost::regex re_definition;
+struct GenerateOptions {
+    bool cache = true;  ///< keep the downloaded dump and the words extracted from it
+    GzipBackend gzip_backend = GzipBackend::zlib;
+    dict::Format format = dict::Format::sqlite;
+    bool full_text = false;  ///< index the terms of descriptions to search words by them
+    bool near_words = false;  ///< index words to find those near misspelled answers
+    int nr_connections = 1;
+    bool incremental = true;  ///< take the descriptions of unchanged articles from the previous dictionary
+    std::string dump_host = "https://dumps.wikimedia.org";  ///< scheme, host and optional port serving the dumps
+    std::string metrics_path;  ///< where to export metrics of each stage every 2 seconds, if not empty
 };
 
-LanguageSpec find_language_spec(std::string_view query);
-void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, bool cache);
+void generate_dictionary(ZStringView path, const LanguageSpec& language_spec, const GenerateOptions& options);
 
 }  // namespace komankondi::dictgen
@@ -0,0 +1,179 @@
+#include "word_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zstd.h>
+
+#include "dict/word.hpp"
+#include "utils/exception.hpp"
+#include "utils/file.hpp"
+#include "utils/log.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+// file layout: frames, then the end offset of each frame, their number and the magic
+constexpr std::array<char, 8> word_cache_magic = {'K', 'M', 'K', 'W', 'O', 'R', 'D', '1'};
+constexpr int compression_level = 3;
+
+void check(size_t code, std::string_view what) {
+    if (ZSTD_isError(code))
+        throw Exception{"Could not {}: {}", what, ZSTD_getErrorName(code)};
+}
+
+template <typename T>
+void append(std::vector<std::byte>& out, const T& value) {
+    std::span<const std::byte> bytes = std::as_bytes(std::span{&value, 1});
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void append_string(std::vector<std::byte>& out, std::string_view str) {
+    append(out, static_cast<uint32_t>(str.size()));
+    std::span<const std::byte> bytes = std::as_bytes(std::span{str});
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+template <typename T>
+T read_value(std::span<const std::byte>& data) {
+    if (data.size() < sizeof(T))
+        throw Exception{"Could not read word cache: truncated record"};
+    T r;
+    std::memcpy(&r, data.data(), sizeof(T));
+    data = data.subspan(sizeof(T));
+    return r;
+}
+
+std::string read_string(std::span<const std::byte>& data) {
+    uint32_t size = read_value<uint32_t>(data);
+    if (data.size() < size)
+        throw Exception{"Could not read word cache: truncated record"};
+    std::string r{reinterpret_cast<const char*>(data.data()), size};
+    data = data.subspan(size);
+    return r;
+}
+
+}  // namespace
+
+
+WordCacheWriter::WordCacheWriter(std::string path) :
+        path_{std::move(path)},
+        tmp_path_{path_ + ".new"},
+        ctx_{ZSTD_createCCtx()} {
+    if (!ctx_)
+        throw Exception{"Could not create compression context"};
+    check(ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_compressionLevel, compression_level), "set compression parameter");
+    check(ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_checksumFlag, 1), "set compression parameter");
+
+    log::debug("Saving words to cache {}", tmp_path_);
+    std::filesystem::create_directories(std::filesystem::path{path_}.parent_path());
+    file_ = {tmp_path_, File::Mode::truncate | File::Mode::binary};
+}
+
+WordCacheWriter::~WordCacheWriter() {
+    if (!file_)
+        return;
+    file_ = {};
+    try {
+        std::filesystem::remove(tmp_path_);
+    }
+    catch (const std::exception& ex) {
+        log::warn("Could not clean incomplete word cache file: {}", ex.what());
+    }
+}
+
+void WordCacheWriter::add_words(std::span<const dict::Word> words) {
+    for (const dict::Word& word : words) {
+        append_string(records_, word.word);
+        append_string(records_, word.description);
+        if (std::ssize(records_) >= frame_size)
+            flush_frame();
+    }
+}
+
+void WordCacheWriter::flush_frame() {
+    if (records_.empty())
+        return;
+    compressed_.resize(ZSTD_compressBound(records_.size()));
+    size_t size = ZSTD_compress2(ctx_.get(), compressed_.data(), compressed_.size(), records_.data(), records_.size());
+    check(size, "compress words");
+    file_.write(std::span<const std::byte>{compressed_}.first(size));
+    size_ += size;
+    frame_ends_.push_back(size_);
+    records_.clear();
+}
+
+void WordCacheWriter::save() {
+    flush_frame();
+    file_.write(std::span<const uint64_t>{frame_ends_});
+    uint64_t nr_frames = frame_ends_.size();
+    file_.write<uint64_t>(std::span{&nr_frames, 1});
+    file_.write<char>(word_cache_magic);
+    file_.sync();
+    file_ = {};
+    std::filesystem::rename(tmp_path_, path_);
+    log::info("Successfully saved words to cache");
+}
+
+
+WordCacheReader::WordCacheReader(ZStringView path) :
+        file_{path, File::Mode::read | File::Mode::binary},
+        ctx_{ZSTD_createDCtx()} {
+    if (!ctx_)
+        throw Exception{"Could not create decompression context"};
+
+    int64_t size = std::filesystem::file_size(path.data());
+    constexpr int64_t trailer_size = sizeof(uint64_t) + word_cache_magic.size();
+    if (size < trailer_size)
+        throw Exception{"Could not read word cache {}: file is too small", path};
+    file_.seek(size - trailer_size);
+    std::vector<std::byte> trailer = file_.read(trailer_size);
+    std::span<const std::byte> trailer_view = trailer;
+    uint64_t nr_frames = read_value<uint64_t>(trailer_view);
+    if (!std::equal(trailer_view.begin(), trailer_view.end(), std::as_bytes(std::span{word_cache_magic}).begin()))
+        throw Exception{"Could not read word cache {}: invalid magic", path};
+    if (nr_frames > static_cast<uint64_t>(size - trailer_size) / sizeof(uint64_t))
+        throw Exception{"Could not read word cache {}: invalid number of frames", path};
+
+    int64_t index_pos = size - trailer_size - static_cast<int64_t>(nr_frames * sizeof(uint64_t));
+    file_.seek(index_pos);
+    frame_ends_ = file_.read<uint64_t>(static_cast<int>(nr_frames));
+    if (frame_ends_.size() != nr_frames || !std::is_sorted(frame_ends_.begin(), frame_ends_.end())
+        || (!frame_ends_.empty() && frame_ends_.back() != static_cast<uint64_t>(index_pos)))
+        throw Exception{"Could not read word cache {}: invalid frame index", path};
+}
+
+int WordCacheReader::nr_frames() const {
+    return static_cast<int>(frame_ends_.size());
+}
+
+std::vector<dict::Word> WordCacheReader::read_frame(int index) {
+    uint64_t begin = index == 0 ? 0 : frame_ends_[index - 1];
+    file_.seek(static_cast<int64_t>(begin));
+    file_.read(compressed_, static_cast<int>(frame_ends_[index] - begin));
+
+    unsigned long long size = ZSTD_getFrameContentSize(compressed_.data(), compressed_.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+        throw Exception{"Could not read word cache: invalid frame"};
+    records_.resize(size);
+    check(ZSTD_decompressDCtx(ctx_.get(), records_.data(), records_.size(), compressed_.data(), compressed_.size()), "decompress words");
+
+    std::vector<dict::Word> r;
+    std::span<const std::byte> records = records_;
+    while (!records.empty()) {
+        std::string word = read_string(records);
+        r.push_back({std::move(word), read_string(records)});
+    }
+    return r;
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <zstd.h>
+
+#include "dict/compression.hpp"
+#include "dict/word.hpp"
+#include "utils/file.hpp"
+#include "utils/zstring_view.hpp"
+
+namespace komankondi::dictgen {
+
+/// Words extracted from a dump, so that generating a dictionary again from the same dump only replays them.
+/// They are stored in independent zstd frames, indexed at the end of the file so each one can be read on its own.
+struct WordCacheWriter {
+    /// Uncompressed size of the records stored in each frame.
+    static constexpr int frame_size = 1 << 20;
+
+    /// Writes to a temporary file, renamed to path on save.
+    explicit WordCacheWriter(std::string path);
+    ~WordCacheWriter();
+    WordCacheWriter(const WordCacheWriter&) = delete;
+    WordCacheWriter& operator=(const WordCacheWriter&) = delete;
+    WordCacheWriter(WordCacheWriter&&) noexcept = delete;
+    WordCacheWriter& operator=(WordCacheWriter&&) noexcept = delete;
+
+    void add_words(std::span<const dict::Word> words);
+
+    void save();
+
+private:
+    std::string path_;
+    std::string tmp_path_;
+    File file_;
+    std::unique_ptr<ZSTD_CCtx> ctx_;
+    std::vector<std::byte> records_;
+    std::vector<std::byte> compressed_;
+    std::vector<uint64_t> frame_ends_;
+    uint64_t size_ = 0;
+
+    void flush_frame();
+};
+
+
+struct WordCacheReader {
+    explicit WordCacheReader(ZStringView path);
+
+    int nr_frames() const;
+
+    std::vector<dict::Word> read_frame(int index);
+
+private:
+    File file_;
+    std::unique_ptr<ZSTD_DCtx> ctx_;
+    std::vector<uint64_t> frame_ends_;
+    std::vector<std::byte> compressed_;
+    std::vector<std::byte> records_;
+};
+
+}  // namespace komankondi::dictgen
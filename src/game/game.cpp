@@ -1,32 +1,103 @@
 #include "game.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
+#include "dict/near_words.hpp"
+#include "utils/levenshtein.hpp"
+#include "utils/log.hpp"
 #include "utils/path.hpp"
+#include "utils/utf8.hpp"
 
 namespace komankondi::game {
+namespace {
+
+std::string dictionary_path(Profile& profile) {
+    return fmt::format("{}/{}.dict", get_data_directory(), profile.dictionary());
+}
+
+}  // namespace
+
 
 Game::Game() :
-        dict_{fmt::format("{}/{}.dict", get_data_directory(), profile_.dictionary())} {
-    solution_ = dict_.pick_word();
+        Game{Profile{}} {
+}
+
+Game::Game(const std::string& dictionary, int prefetch_depth, int tolerance) :
+        dict_{dictionary, prefetch_depth},
+        tolerance_{tolerance} {
+    if (tolerance_ > 0) {
+        std::string path = dict::near_words_path(dictionary);
+        if (std::filesystem::exists(path))
+            near_words_.emplace(path);
+        else
+            log::warn("Could not find near words of the dictionary, answers that are other words will be taken as typos");
+    }
+    next_word();
 }
 
 const std::string& Game::description() const {
     return solution_.description;
 }
 
-bool Game::submit(std::string_view word) {
+bool Game::type(std::string_view word) {
     if (word != solution_.word)
         return false;
-    solution_ = dict_.pick_word();
+    next_word();
     return true;
 }
 
+Game::Answer Game::submit(std::string_view word) {
+    Answer r;
+    if (word == solution_.word) {
+        r.correct = true;
+    }
+    else if (tolerance_ > 0 && !word.empty()) {
+        std::vector<dict::NearWords::Match> near;
+        if (near_words_)
+            near = near_words_->find(word, tolerance_, max_near_words + 2);
+
+        // a word of the dictionary is a different answer, not a typo
+        bool other_word = !near.empty() && near.front().distance == 0;
+        int distance = solution_automaton_->distance(word);
+        if (!other_word && distance <= solution_automaton_->max_distance()) {
+            r.correct = true;
+            r.distance = distance;
+        }
+        else {
+            for (dict::NearWords::Match& match : near) {
+                if (match.distance > 0 && match.word != solution_.word && std::ssize(r.near_words) < max_near_words)
+                    r.near_words.push_back(std::move(match.word));
+            }
+        }
+    }
+
+    if (r.correct)
+        next_word();
+    return r;
+}
+
 std::string Game::give_up() {
     std::string r = std::move(solution_.word);
-    solution_ = dict_.pick_word();
+    next_word();
     return r;
 }
 
+Game::Game(Profile&& profile) :
+        Game{dictionary_path(profile), profile.prefetch_depth(), profile.tolerance()} {
+}
+
+void Game::next_word() {
+    solution_ = dict_.pick_word();
+    // short words are too close to many others to allow as many edits
+    if (tolerance_ > 0) {
+        int length = decode_utf8(solution_.word).size();
+        solution_automaton_.emplace(solution_.word, std::min(tolerance_, (length - 1) / 2));
+    }
+}
+
 }  // namespace komankondi::game
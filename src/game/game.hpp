@@ -1,26 +1,51 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
-#include "dict/reader.hpp"
+#include "dict/near_words.hpp"
+#include "dict/prefetcher.hpp"
 #include "dict/word.hpp"
 #include "game/profile.hpp"
+#include "utils/levenshtein.hpp"
 
 namespace komankondi::game {
 
 struct Game {
+    /// Words of the dictionary reported near a wrong answer.
+    static constexpr int max_near_words = 5;
+
+    struct Answer {
+        bool correct = false;
+        int distance = 0;                     ///< edits from the solution of a correct answer
+        std::vector<std::string> near_words;  ///< words of the dictionary within the tolerance of a wrong answer, the nearest first
+    };
+
     Game();
+    /// Game with the dictionary at the given path and settings, instead of those of the profile.
+    Game(const std::string& dictionary, int prefetch_depth, int tolerance);
 
     const std::string& description() const;
 
-    bool submit(std::string_view word);
+    /// Answer being typed, correct only when it is the solution: prefixes of it may be within the tolerance.
+    bool type(std::string_view word);
+    /// Answer given as complete. With a tolerance, answers a few edits away from the solution are correct too,
+    /// as long as they are not other words.
+    Answer submit(std::string_view word);
     std::string give_up();
 
 private:
-    Profile profile_;
-    dict::Reader dict_;
+    dict::Prefetcher dict_;
+    int tolerance_;
+    std::optional<dict::NearWords> near_words_;
     dict::Word solution_;
+    std::optional<LevenshteinAutomaton> solution_automaton_;
+
+    explicit Game(Profile&& profile);
+
+    void next_word();
 };
 
 }  // namespace komankondi::game
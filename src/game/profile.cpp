@@ -3,6 +3,7 @@
 #include <string>
 #include <tuple>
 
+#include "utils/exception.hpp"
 #include "utils/path.hpp"
 #include "utils/zstring_view.hpp"
 
@@ -19,4 +20,18 @@ std::string Profile::dictionary() {
     return std::get<0>(db_.exec<std::tuple<std::string>>("SELECT value FROM settings WHERE key='dictionary'"));
 }
 
+int Profile::prefetch_depth() {
+    int r = std::get<0>(db_.exec<std::tuple<int>>("SELECT ifnull((SELECT value FROM settings WHERE key='prefetch_depth'), 8)"));
+    if (r < 1)
+        throw Exception{"Could not use prefetch depth {}: must be at least 1", r};
+    return r;
+}
+
+int Profile::tolerance() {
+    int r = std::get<0>(db_.exec<std::tuple<int>>("SELECT ifnull((SELECT value FROM settings WHERE key='tolerance'), 0)"));
+    if (r < 0 || r > 3)
+        throw Exception{"Could not use tolerance {}: must be between 0 and 3", r};
+    return r;
+}
+
 }  // namespace komankondi::game
@@ -10,6 +10,9 @@ struct Profile {
     Profile();
 
     std::string dictionary();
+    int prefetch_depth();
+    /// Edits allowed in answers, at most 3.
+    int tolerance();
 
 private:
     Database db_;
@@ -1,6 +1,9 @@
 #include "context.hpp"
 
+#include <string>
+
 #include <QString>
+#include <QStringList>
 
 namespace komankondi::ui {
 
@@ -8,8 +11,23 @@ QString Context::description() const {
     return QString::fromStdString(game_.description());
 }
 
+bool Context::type(const QString& word) {
+    if (!game_.type(word.toStdString()))
+        return false;
+    near_words_.clear();
+    return true;
+}
+
 bool Context::submit(const QString& word) {
-    return game_.submit(word.toStdString());
+    game::Game::Answer answer = game_.submit(word.toStdString());
+    near_words_.clear();
+    for (const std::string& near_word : answer.near_words)
+        near_words_.append(QString::fromStdString(near_word));
+    return answer.correct;
+}
+
+QStringList Context::near_words() const {
+    return near_words_;
 }
 
 }  // namespace komankondi::ui
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QQmlEngine>
 #include <QString>
+#include <QStringList>
 
 #include "game/game.hpp"
 
@@ -11,10 +12,16 @@ namespace komankondi::ui {
 struct Context : QObject {
 public:
     Q_INVOKABLE QString description() const;
+    /// Exact answer checked as it is typed.
+    Q_INVOKABLE bool type(const QString& word);
+    /// Complete answer, that may have typos.
     Q_INVOKABLE bool submit(const QString& word);
+    /// Words of the dictionary near the last wrong submitted answer.
+    Q_INVOKABLE QStringList near_words() const;
 
 private:
     game::Game game_;
+    QStringList near_words_;
 
     Q_OBJECT
     QML_ELEMENT
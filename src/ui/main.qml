@@ -16,14 +16,32 @@ Rectangle {
             color: "white"
             font.pointSize: 48
 
+            // typos are only accepted once the answer is complete, not to cut it short while typing it
             onTextChanged: {
+                if (Context.type(text)) {
+                    text = "";
+                    description.text = Context.description();
+                    nearWords.text = "";
+                }
+            }
+            onAccepted: {
                 if (Context.submit(text)) {
                     text = "";
                     description.text = Context.description();
                 }
+                nearWords.text = Context.near_words().join(", ");
             }
         }
 
+        Text {
+            id: nearWords
+
+            Layout.alignment: Qt.AlignHCenter
+
+            color: "gray"
+            font.pointSize: 16
+        }
+
         Text {
             id: description
 
@@ -0,0 +1,91 @@
+#include "utils/buffer_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace komankondi {
+namespace {
+
+/// Smallest class whose buffers all have at least the given capacity.
+int ceil_class(size_t capacity) {
+    return std::bit_width(std::max<size_t>(capacity, 1) - 1);
+}
+
+/// Largest class whose buffers all have at most the given capacity.
+int floor_class(size_t capacity) {
+    return std::bit_width(capacity) - 1;
+}
+
+}  // namespace
+
+
+BufferPool::Buffer::Buffer(BufferPool& pool, std::vector<std::byte>&& data) :
+        pool_{&pool}, data_{std::move(data)} {
+}
+
+BufferPool::Buffer::~Buffer() {
+    if (pool_)
+        pool_->recycle(std::move(data_));
+}
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept :
+        pool_{std::exchange(other.pool_, nullptr)}, data_{std::move(other.data_)} {
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        if (pool_)
+            pool_->recycle(std::move(data_));
+        pool_ = std::exchange(other.pool_, nullptr);
+        data_ = std::move(other.data_);
+    }
+    return *this;
+}
+
+
+BufferPool::Buffer BufferPool::get(size_t capacity) {
+    std::vector<std::byte> r;
+    {
+        GuardedHandle<Shared> s = shared_.lock();
+        for (int i = ceil_class(capacity); i < std::ssize(s->free); ++i) {
+            if (!s->free[i].empty()) {
+                r = std::move(s->free[i].back());
+                s->free[i].pop_back();
+                break;
+            }
+        }
+        if (r.capacity() == 0)
+            ++s->stats.allocated;
+        s->stats.peak_in_use = std::max(s->stats.peak_in_use, ++s->stats.in_use);
+    }
+
+    if (r.capacity() == 0 && capacity > 0)
+        r.reserve(size_t{1} << ceil_class(capacity));
+    return {*this, std::move(r)};
+}
+
+BufferPool::Stats BufferPool::stats() {
+    return shared_.lock()->stats;
+}
+
+void BufferPool::recycle(std::vector<std::byte>&& data) {
+    data.clear();
+    GuardedHandle<Shared> s = shared_.lock();
+    --s->stats.in_use;
+    if (data.capacity() == 0) {
+        --s->stats.allocated;
+        return;
+    }
+    try {
+        s->free[floor_class(data.capacity())].push_back(std::move(data));
+    }
+    catch (const std::bad_alloc&) {
+        --s->stats.allocated;
+    }
+}
+
+}  // namespace komankondi
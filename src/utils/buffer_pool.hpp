@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils/guarded.hpp"
+
+namespace komankondi {
+
+/// Thread-safe pool of byte buffers, sorted in power of two capacity classes, recycled instead of freed.
+struct BufferPool {
+    /// Owns a buffer of the pool, and gives it back when destroyed.
+    struct Buffer {
+        Buffer() = default;
+        ~Buffer();
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+
+        const std::vector<std::byte>& operator*() const {
+            return data_;
+        }
+        std::vector<std::byte>& operator*() {
+            return data_;
+        }
+
+        const std::vector<std::byte>* operator->() const {
+            return &data_;
+        }
+        std::vector<std::byte>* operator->() {
+            return &data_;
+        }
+
+    private:
+        friend BufferPool;
+
+        BufferPool* pool_ = nullptr;
+        std::vector<std::byte> data_;
+
+        Buffer(BufferPool& pool, std::vector<std::byte>&& data);
+    };
+
+    struct Stats {
+        int64_t in_use = 0;
+        int64_t peak_in_use = 0;
+        int64_t allocated = 0;  ///< in use or waiting to be reused
+    };
+
+    BufferPool() = default;
+    ~BufferPool() = default;
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    BufferPool(BufferPool&&) noexcept = delete;
+    BufferPool& operator=(BufferPool&&) noexcept = delete;
+
+    /// Empty buffer with at least the given capacity.
+    Buffer get(size_t capacity = 0);
+
+    Stats stats();
+
+private:
+    struct Shared {
+        std::array<std::vector<std::vector<std::byte>>, 64> free;
+        Stats stats;
+    };
+    Guarded<Shared> shared_;
+
+    void recycle(std::vector<std::byte>&& data);
+};
+
+}  // namespace komankondi
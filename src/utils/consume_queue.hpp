@@ -1,67 +1,209 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
-#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
-#include <queue>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
 
 #include "utils/config.hpp"
-#include "utils/guarded.hpp"
 
 namespace komankondi {
 
-/// Thread-safe multi-producers multi-consumers queue.
-template <typename Element>
+enum class QueueMode {
+    spsc,  ///< one thread at a time pushes, and one at a time pops
+    mpmc,
+};
+
+/// Thread-safe bounded queue, lock-free as long as it is neither empty when popping nor full when pushing.
+/// It then spins briefly before parking the thread until there is something to pop or room to push.
+template <typename Element, QueueMode mode = QueueMode::mpmc>
 struct ConsumeQueue {
-    ConsumeQueue() = default;
+    ConsumeQueue() :
+            ConsumeQueue(default_parallel_queue_size()) {
+    }
     explicit ConsumeQueue(int max_size) :
-            max_size_{max_size} {
-        assert(max_size_ > 0);
+            max_size_{static_cast<uint64_t>(max_size)},
+            slots_{std::make_unique<Slot[]>(max_size)} {
+        assert(max_size > 0);
+        for (uint64_t i = 0; i < max_size_; ++i)
+            slots_[i].sequence.store(2 * i, std::memory_order::relaxed);
     }
 
+    ConsumeQueue(const ConsumeQueue&) = delete;
+    ConsumeQueue& operator=(const ConsumeQueue&) = delete;
+
+    /// Make pushes fail, and pops fail once the queue is empty.
+    /// Closing sets a bit of the push position, so that a push either claims its slot before, and is popped,
+    /// or fails: no push returns true after a pop returned nothing because of closing.
     void close() {
-        shared_.lock()->closed = true;
-        condvar_push_.notify_all();
-        condvar_pop_.notify_all();
+        push_position_.fetch_or(closed_bit, std::memory_order::seq_cst);
+        wake(push_waiters_, true);
+        wake(pop_waiters_, true);
     }
 
     bool push(Element&& element) {
-        {
-            GuardedHandle<Shared> s = shared_.lock();
-            s.wait(condvar_push_, [&] { return s->closed || std::ssize(s->queue) < max_size_; });
-            if (s->closed)
+        for (int spin = 0;; ++spin) {
+            if (closed())
                 return false;
-            s->queue.push(std::move(element));
+            if (try_push(element)) {
+                wake(pop_waiters_, false);
+                return true;
+            }
+            if (spin < spin_count)
+                pause(spin);
+            else
+                park(push_waiters_, [&] { return can_push(); });
         }
-        condvar_pop_.notify_one();
-        return true;
     }
 
     std::optional<Element> pop() {
-        std::optional<Element> r;
-        {
-            GuardedHandle<Shared> s = shared_.lock();
-            s.wait(condvar_pop_, [&] { return s->closed || !s->queue.empty(); });
-            if (s->closed && s->queue.empty())
+        for (int spin = 0;; ++spin) {
+            if (std::optional<Element> r = try_pop())
+                return r;
+            // elements pushed before closing are still popped, including those whose slot is claimed but not filled yet
+            if (uint64_t push_position = push_position_.load(std::memory_order::acquire); push_position & closed_bit) {
+                if (pop_position_.load(std::memory_order::relaxed) >= (push_position & ~closed_bit))
+                    return {};
+                pause(spin);
+                continue;
+            }
+            if (spin < spin_count)
+                pause(spin);
+            else
+                park(pop_waiters_, [&] { return can_pop(); });
+        }
+    }
+
+    /// Same as pop, but returns nothing instead of waiting when queue is empty.
+    std::optional<Element> try_pop() {
+        uint64_t position = pop_position_.load(std::memory_order::relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position % max_size_];
+            int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order::acquire) - (2 * position + 1));
+            if (diff < 0)
                 return {};
-            r = std::move(s->queue.front());
-            s->queue.pop();
+            if (diff > 0) {
+                position = pop_position_.load(std::memory_order::relaxed);
+                continue;
+            }
+            if constexpr (mode == QueueMode::spsc) {
+                pop_position_.store(position + 1, std::memory_order::relaxed);
+                break;
+            }
+            else if (pop_position_.compare_exchange_weak(position, position + 1, std::memory_order::relaxed)) {
+                break;
+            }
         }
-        condvar_push_.notify_one();
+
+        std::optional<Element> r = std::move(slot->element);
+        slot->element.reset();
+        slot->sequence.store(2 * (position + max_size_), std::memory_order::release);
+        wake(push_waiters_, false);
         return r;
     }
 
 private:
-    int max_size_ = default_parallel_queue_size();
+    static constexpr int spin_count = 32;  ///< first half pausing the cpu, second half yielding it
+    static constexpr size_t cache_line_size = 64;
+    static constexpr uint64_t closed_bit = uint64_t{1} << 63;  ///< of the push position
+
+    /// Each slot is ready to be pushed to at position when its sequence is 2 * position, and popped from when 2 * position + 1.
+    /// Doubling keeps a slot popped from at position apart from being pushed to at position + 1 with a single slot.
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::optional<Element> element;
+    };
 
-    struct Shared {
-        bool closed = false;
-        std::queue<Element> queue;
+    /// Threads parked waiting for the queue to change, all woken up at once through the epoch.
+    struct Waiters {
+        alignas(cache_line_size) std::atomic<uint32_t> epoch = 0;
+        std::atomic<bool> parked = false;
     };
-    Guarded<Shared> shared_;
 
-    std::condition_variable condvar_push_;
-    std::condition_variable condvar_pop_;
+    const uint64_t max_size_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(cache_line_size) std::atomic<uint64_t> push_position_ = 0;
+    alignas(cache_line_size) std::atomic<uint64_t> pop_position_ = 0;
+    Waiters push_waiters_;
+    Waiters pop_waiters_;
+
+    /// Leaves element untouched when failing because the queue is full or closed.
+    bool try_push(Element& element) {
+        uint64_t position = push_position_.load(std::memory_order::relaxed);
+        Slot* slot;
+        while (true) {
+            if (position & closed_bit)
+                return false;
+            slot = &slots_[position % max_size_];
+            int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order::acquire) - 2 * position);
+            if (diff < 0)
+                return false;
+            if (diff > 0) {
+                position = push_position_.load(std::memory_order::relaxed);
+                continue;
+            }
+            // even with a single producer, closing can change the position concurrently
+            if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order::relaxed))
+                break;
+        }
+
+        slot->element.emplace(std::move(element));
+        slot->sequence.store(2 * position + 1, std::memory_order::release);
+        return true;
+    }
+
+    bool closed() const {
+        return push_position_.load(std::memory_order::acquire) & closed_bit;
+    }
+
+    bool can_push() const {
+        uint64_t position = push_position_.load(std::memory_order::relaxed);
+        return position & closed_bit || slots_[position % max_size_].sequence.load(std::memory_order::acquire) == 2 * position;
+    }
+
+    bool can_pop() const {
+        uint64_t position = pop_position_.load(std::memory_order::relaxed);
+        return closed() || slots_[position % max_size_].sequence.load(std::memory_order::acquire) == 2 * position + 1;
+    }
+
+    static void pause(int spin) {
+#if defined(__x86_64__) || defined(__i386__)
+        if (spin < spin_count / 2) {
+            _mm_pause();
+            return;
+        }
+#endif
+        std::this_thread::yield();
+    }
+
+    // The fences order the change of the queue and the read of the parked flag in wake(), against the
+    // setting of the flag and the check of the queue in park(), so that a change is never missed.
+    // Only the first wake after threads parked makes the system call, they set the flag again if they park again.
+
+    static void wake(Waiters& waiters, bool always) {
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (always || (waiters.parked.load(std::memory_order::relaxed) && waiters.parked.exchange(false, std::memory_order::relaxed))) {
+            waiters.epoch.fetch_add(1, std::memory_order::release);
+            waiters.epoch.notify_all();
+        }
+    }
+
+    template <typename Ready>
+    static void park(Waiters& waiters, Ready&& ready) {
+        uint32_t epoch = waiters.epoch.load(std::memory_order::acquire);
+        waiters.parked.store(true, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        if (!ready())
+            waiters.epoch.wait(epoch, std::memory_order::acquire);
+    }
 };
 
 }  // namespace komankondi
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <range/v3/iterator/operations.hpp>
 #include <range/v3/view/split.hpp>
@@ -64,6 +68,16 @@ struct Database {
             }
         }
 
+        /// Execute once with the arguments of all rows, for operations with parameters for that many rows like multi-row inserts.
+        template <typename... Args>
+        void exec_rows(std::span<const std::tuple<Args...>> rows) {
+            reset();
+            for (size_t i = 0; i < rows.size(); ++i)
+                std::apply([&](const auto&... a) { bind(1 + i * sizeof...(Args), a...); }, rows[i]);
+            if (step())
+                throw Exception{"Operation returned a row, expected none"};
+        }
+
     private:
         std::unique_ptr<sqlite3_stmt> handle_;
 
@@ -84,6 +98,11 @@ struct Database {
                     else if constexpr (std::is_same_v<T, std::string_view>) {
                         return sqlite3_bind_text(handle_.get(), index, value.data(), value.size(), SQLITE_STATIC);
                     }
+                    else if constexpr (std::is_same_v<T, std::span<const std::byte>>) {
+                        if (value.empty())  // a null pointer would bind NULL
+                            return sqlite3_bind_zeroblob(handle_.get(), index, 0);
+                        return sqlite3_bind_blob(handle_.get(), index, value.data(), value.size(), SQLITE_STATIC);
+                    }
                     else {
                         static_assert(always_false<T>);
                     }
@@ -114,6 +133,13 @@ struct Database {
                     throw Exception{"Could not fetch string from database operation: {}", sqlite3_errmsg(sqlite3_db_handle(handle_.get()))};
                 value = {ptr, static_cast<size_t>(size)};
             }
+            else if constexpr (std::is_same_v<T, std::vector<std::byte>>) {
+                const std::byte* ptr = static_cast<const std::byte*>(sqlite3_column_blob(handle_.get(), index));
+                int size = sqlite3_column_bytes(handle_.get(), index);
+                if (!ptr && size > 0)
+                    throw Exception{"Could not fetch blob from database operation: {}", sqlite3_errmsg(sqlite3_db_handle(handle_.get()))};
+                value.assign(ptr, ptr + size);
+            }
             else {
                 static_assert(always_false<T>);
             }
@@ -153,6 +179,12 @@ struct Database {
             return op_.exec(std::forward<Visitor>(visitor), args...);
         }
 
+        void exec_rows(std::span<const std::tuple<Args...>> rows) {
+            static_assert(std::is_same_v<Result, void>);
+
+            op_.exec_rows(rows);
+        }
+
     private:
         OperationAny op_;
     };
@@ -1,6 +1,7 @@
 #include "file.hpp"
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <filesystem>
 #include <string>
@@ -66,6 +67,11 @@ void File::sync() {
     fsync(stream_.get());
 }
 
+void File::seek(int64_t position) {
+    if (std::fseek(stream_.get(), position, SEEK_SET))
+        throw SystemException{"Could not seek in file"};
+}
+
 File::Mode operator|(File::Mode a, File::Mode b) {
     return static_cast<File::Mode>(static_cast<int>(a) | static_cast<int>(b));
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <span>
@@ -37,18 +38,29 @@ struct File {
 
     void sync();
 
+    /// Move to the given position from the start of the file.
+    void seek(int64_t position);
+
     template <typename T = std::byte>
     std::vector<T> read(int size = default_buffer_size / sizeof(T)) {
         std::vector<T> r;
-        r.resize(size);
-        r.resize(std::fread(r.data(), sizeof(T), r.size(), stream_.get()));
+        read(r, size);
+        return r;
+    }
+
+    /// Same as read, but reuses the memory of the given vector.
+    template <typename T>
+    void read(std::vector<T>& out, int size = default_buffer_size / sizeof(T)) {
+        out.resize(size);
+        out.resize(std::fread(out.data(), sizeof(T), out.size(), stream_.get()));
         if (std::ferror(stream_.get()))
             throw SystemException{"Could not read from file"};
-        return r;
     }
 
     template <typename T>
     void write(std::span<const T> data) {
+        if (data.empty())  // its pointer may be null
+            return;
         if (std::fwrite(data.data(), sizeof(T), data.size(), stream_.get()) < data.size())
             throw SystemException{"Could not write to file"};
     }
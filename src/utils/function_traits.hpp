@@ -34,7 +34,7 @@ template <typename R, typename... Args>
 struct FunctionTraits<R (*)(Args...)> : FunctionTraits<R(Args...)> {};
 
 template <typename R, typename... Args>
-struct FunctionTraits<R(Args...)> : FunctionTraits<R()> {
+struct FunctionTraits<R(Args...)> {
     using Return = R;
 
     static constexpr int nr_args = sizeof...(Args);
@@ -0,0 +1,62 @@
+#include "levenshtein.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "utils/exception.hpp"
+#include "utils/utf8.hpp"
+
+namespace komankondi {
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view word, int max_distance) :
+        word_{decode_utf8(word)} {
+    if (max_distance < 0 || max_distance >= UINT8_MAX)
+        throw Exception{"Could not match words within {} edits: must be between 0 and {}", max_distance, UINT8_MAX - 1};
+    max_distance_ = max_distance;
+}
+
+int LevenshteinAutomaton::max_distance() const {
+    return max_distance_;
+}
+
+LevenshteinAutomaton::State LevenshteinAutomaton::start() const {
+    State r(word_.size() + 1);
+    for (size_t i = 0; i < r.size(); ++i)
+        r[i] = std::min<size_t>(i, max_distance_ + 1);
+    return r;
+}
+
+void LevenshteinAutomaton::step(const State& state, char32_t c, State& next) const {
+    uint8_t cap = max_distance_ + 1;
+    next.resize(state.size());
+    next[0] = std::min<uint8_t>(state[0] + 1, cap);
+    for (size_t i = 1; i < state.size(); ++i) {
+        int substitution = state[i - 1] + (word_[i - 1] != c);
+        int edit = std::min(substitution, std::min(state[i], next[i - 1]) + 1);
+        next[i] = std::min<int>(edit, cap);
+    }
+}
+
+int LevenshteinAutomaton::distance(const State& state) const {
+    return state.back();
+}
+
+bool LevenshteinAutomaton::can_match(const State& state) const {
+    return *std::min_element(state.begin(), state.end()) <= max_distance_;
+}
+
+int LevenshteinAutomaton::distance(std::string_view str) const {
+    State state = start();
+    State next;
+    for (size_t pos = 0; pos < str.size();) {
+        step(state, next_code_point(str, pos), next);
+        std::swap(state, next);
+        if (!can_match(state))
+            return max_distance_ + 1;
+    }
+    return distance(state);
+}
+
+}  // namespace komankondi
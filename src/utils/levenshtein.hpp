@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace komankondi {
+
+/// Accepts the strings within max_distance insertions, deletions or substitutions of code points of a word.
+/// States are rows of the edit distance matrix capped at max_distance + 1, so strings are read one code point at a time
+/// and the states reached through a prefix serve all strings starting with it.
+struct LevenshteinAutomaton {
+    using State = std::vector<uint8_t>;
+
+    LevenshteinAutomaton(std::string_view word, int max_distance);
+
+    int max_distance() const;
+
+    State start() const;
+    /// State after reading c from state, reusing the memory of next.
+    void step(const State& state, char32_t c, State& next) const;
+    /// Distance of the string read to reach state, max_distance + 1 if further.
+    int distance(const State& state) const;
+    /// Whether any string starting with the one read to reach state is accepted.
+    bool can_match(const State& state) const;
+
+    /// Distance of str, max_distance + 1 if further.
+    int distance(std::string_view str) const;
+
+private:
+    std::u32string word_;
+    uint8_t max_distance_;
+};
+
+}  // namespace komankondi
@@ -0,0 +1,49 @@
+#include "newlines.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#ifdef __AVX2__
+#  include <immintrin.h>
+#endif
+
+namespace komankondi {
+
+void find_newlines(std::string_view text, std::vector<size_t>& out) {
+    size_t pos = 0;
+#ifdef __AVX2__
+    const __m256i newline = _mm256_set1_epi8('\n');
+    auto matches = [&](size_t offset) {
+        return _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + offset)), newline);
+    };
+    // lines are usually long, so blocks of 128 bytes without any newline are skipped with a single test
+    for (; pos + 128 <= text.size(); pos += 128) {
+        __m256i a = matches(pos), b = matches(pos + 32), c = matches(pos + 64), d = matches(pos + 96);
+        if (_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), _mm256_set1_epi8(-1)))
+            continue;
+        size_t offset = pos;
+        for (__m256i block : {a, b, c, d}) {
+            for (uint32_t mask = _mm256_movemask_epi8(block); mask; mask &= mask - 1)
+                out.push_back(offset + std::countr_zero(mask));
+            offset += 32;
+        }
+    }
+    for (; pos + 32 <= text.size(); pos += 32) {
+        for (uint32_t mask = _mm256_movemask_epi8(matches(pos)); mask; mask &= mask - 1)
+            out.push_back(pos + std::countr_zero(mask));
+    }
+#endif
+    while (pos < text.size()) {
+        const void* found = std::memchr(text.data() + pos, '\n', text.size() - pos);
+        if (!found)
+            break;
+        pos = static_cast<const char*>(found) - text.data();
+        out.push_back(pos++);
+    }
+}
+
+}  // namespace komankondi
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace komankondi {
+
+/// Append the offset of each '\n' of text to out, 128 bytes at a time with AVX2.
+void find_newlines(std::string_view text, std::vector<size_t>& out);
+
+}  // namespace komankondi
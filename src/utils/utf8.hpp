@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace komankondi {
+
+inline void append_utf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        out += static_cast<char>(0xc0 | code >> 6);
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else if (code < 0x10000) {
+        out += static_cast<char>(0xe0 | code >> 12);
+        out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else {
+        out += static_cast<char>(0xf0 | code >> 18);
+        out += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+        out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+/// Code point starting at pos in str, moving pos past it. Bytes that do not start a valid sequence are taken as one code point each.
+inline char32_t next_code_point(std::string_view str, size_t& pos) {
+    auto byte = [&](size_t i) -> uint32_t { return static_cast<unsigned char>(str[i]); };
+    uint32_t first = byte(pos);
+    int length = first < 0x80 ? 1 : first >= 0xc2 && first < 0xe0 ? 2 : first >= 0xe0 && first < 0xf0 ? 3 : first >= 0xf0 && first < 0xf5 ? 4 : 0;
+    if (length <= 1 || pos + length > str.size()) {
+        ++pos;
+        return first;
+    }
+
+    uint32_t r = first & (0x7f >> length);
+    for (int i = 1; i < length; ++i) {
+        if ((byte(pos + i) & 0xc0) != 0x80) {
+            ++pos;
+            return first;
+        }
+        r = r << 6 | (byte(pos + i) & 0x3f);
+    }
+    // overlong, surrogate or out of range
+    if ((length == 3 && r < 0x800) || (r >= 0xd800 && r < 0xe000) || (length == 4 && (r < 0x10000 || r > 0x10ffff))) {
+        ++pos;
+        return first;
+    }
+    pos += length;
+    return r;
+}
+
+inline std::u32string decode_utf8(std::string_view str) {
+    std::u32string r;
+    for (size_t pos = 0; pos < str.size();)
+        r += next_code_point(str, pos);
+    return r;
+}
+
+}  // namespace komankondi
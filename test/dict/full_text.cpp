@@ -0,0 +1,19 @@
+#include "dict/full_text.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_tokenize") {
+    CHECK(tokenize("") == std::vector<std::string>{});
+    CHECK(tokenize(" ,;\n") == std::vector<std::string>{});
+    CHECK(tokenize("Noun:\n- A small CAT, 2nd\tof_them.") == std::vector<std::string>{"noun", "a", "small", "cat", "2nd", "of", "them"});
+    // non-ASCII bytes are part of terms, and left as they are
+    CHECK(tokenize("Été-chaud wörld") == std::vector<std::string>{"Été", "chaud", "wörld"});
+    CHECK(tokenize("\"cat\" OR dog*") == std::vector<std::string>{"cat", "or", "dog"});
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,115 @@
+#include "dict/near_words.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/format.hpp"
+#include "dict/writer.hpp"
+#include "temp_directory.hpp"
+#include "utils/levenshtein.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_near_words") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "test.near").string();
+
+    write_near_words(path, {"cat", "cart", "bat", "chat", "château", "chateau", "dog", "", "catalog", "cats"});
+    NearWords near_words{path};
+    CHECK(near_words.nr_words() == 10);
+
+    auto find = [&](std::string_view word, int max_distance, int limit = 100) {
+        std::vector<std::pair<std::string, int>> r;
+        for (const NearWords::Match& match : near_words.find(word, max_distance, limit))
+            r.emplace_back(match.word, match.distance);
+        return r;
+    };
+    using Expected = std::vector<std::pair<std::string, int>>;
+    CHECK(find("cat", 0) == Expected{{"cat", 0}});
+    CHECK(find("cat", 1) == Expected{{"cat", 0}, {"bat", 1}, {"cart", 1}, {"cats", 1}, {"chat", 1}});
+    CHECK(find("cat", 1, 2) == Expected{{"cat", 0}, {"bat", 1}});
+    CHECK(find("chateau", 1) == Expected{{"chateau", 0}, {"château", 1}});
+    CHECK(find("", 1) == Expected{{"", 0}});
+    CHECK(find("zzzzz", 2).empty());
+    CHECK(find("cat", 1, 0).empty());
+}
+
+TEST_CASE("dict_near_words_random") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "test.near").string();
+
+    unsigned state = 1;
+    auto random_word = [&] {
+        std::string r;
+        state = state * 1103515245 + 12345;
+        for (unsigned i = 1 + (state >> 8) % 7; i > 0; --i) {
+            state = state * 1103515245 + 12345;
+            unsigned letter = (state >> 8) % 6;
+            r += letter == 5 ? "é" : std::string(1, static_cast<char>('a' + letter));
+        }
+        return r;
+    };
+    std::set<std::string> word_set;
+    while (word_set.size() < 3000)
+        word_set.insert(random_word());
+    std::vector<std::string> words{word_set.begin(), word_set.end()};
+    write_near_words(path, words);
+    NearWords near_words{path};
+
+    for (int i = 0; i < 200; ++i) {
+        std::string query = random_word();
+        for (int max_distance : {1, 2}) {
+            INFO(query << " " << max_distance);
+            LevenshteinAutomaton automaton{query, max_distance};
+            std::vector<std::pair<int, std::string>> expected;
+            for (const std::string& word : words) {
+                if (int distance = automaton.distance(word); distance <= max_distance)
+                    expected.emplace_back(distance, word);
+            }
+            std::sort(expected.begin(), expected.end());
+
+            std::vector<std::pair<int, std::string>> r;
+            for (NearWords::Match& match : near_words.find(query, max_distance, 10'000))
+                r.emplace_back(match.distance, std::move(match.word));
+            CHECK(r == expected);
+        }
+    }
+}
+
+TEST_CASE("dict_near_words_writer") {
+    TempDirectory dir;
+
+    for (Format format : {Format::sqlite, Format::native}) {
+        INFO(fmt::to_string(format));
+        std::string path = (dir.path() / fmt::format("{}.dict", format)).string();
+
+        {
+            Writer writer{path, format, false, true};
+            for (int i = 0; i < 100; ++i)
+                writer.add_word(fmt::format("word{}", i), "description");
+            writer.save();
+        }
+        REQUIRE(std::filesystem::exists(near_words_path(path)));
+        CHECK(!std::filesystem::exists(near_words_path(path) + ".new"));
+        NearWords near_words{near_words_path(path)};
+        CHECK(near_words.nr_words() == 100);
+        CHECK(near_words.find("wrd42", 1, 100).size() == 1);
+
+        // a dictionary saved without them does not keep those of the previous one
+        {
+            Writer writer{path, format};
+            writer.add_word("word", "description");
+            writer.save();
+        }
+        CHECK(!std::filesystem::exists(near_words_path(path)));
+    }
+}
+
+}  // namespace komankondi::dict
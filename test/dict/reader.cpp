@@ -0,0 +1,117 @@
+#include "dict/reader.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/format.hpp"
+#include "dict/native.hpp"
+#include "dict/word.hpp"
+#include "dict/writer.hpp"
+#include "temp_directory.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_reader") {
+    TempDirectory dir;
+
+    for (Format format : {Format::sqlite, Format::native}) {
+        INFO(fmt::to_string(format));
+        std::string path = (dir.path() / fmt::format("{}.dict", format)).string();
+
+        constexpr int nr_words = 1000;
+        {
+            Writer writer{path, format};
+            for (int i = 0; i < nr_words; ++i)
+                writer.add_word(fmt::format("word{}", i), fmt::format("description {}", i));
+            writer.add_word("", "empty");
+            writer.save();
+        }
+        CHECK(is_native_dictionary(path) == (format == Format::native));
+
+        Reader reader{path};
+        for (int i = 0; i < nr_words; ++i)
+            CHECK(reader.find_description(fmt::format("word{}", i)) == fmt::format("description {}", i));
+        CHECK(reader.find_description("") == "empty");
+        CHECK(!reader.find_description("word"));
+        CHECK(!reader.find_description("word1000"));
+
+        std::set<std::string> picked;
+        for (int i = 0; i < 100; ++i) {
+            Word word = reader.pick_word();
+            CHECK(reader.find_description(word.word) == word.description);
+            picked.insert(word.word);
+        }
+        CHECK(picked.size() > 50);
+    }
+}
+
+TEST_CASE("dict_reader_search") {
+    TempDirectory dir;
+
+    std::vector<std::vector<Word>> results;
+    for (Format format : {Format::sqlite, Format::native}) {
+        INFO(fmt::to_string(format));
+        std::string path = (dir.path() / fmt::format("{}.dict", format)).string();
+        std::string plain_path = (dir.path() / fmt::format("{}_plain.dict", format)).string();
+
+        for (const std::string& p : {path, plain_path}) {
+            Writer writer{p, format, p == path};
+            for (int i = 0; i < 1000; ++i)
+                writer.add_word(fmt::format("word{}", i), fmt::format("Noun:\n- description {}", i));
+            writer.add_word("cat", "Noun:\n- a cat, cat, CAT!");
+            writer.add_word("kitten", "Noun:\n- a young cat of some domestic animal");
+            writer.add_word("dogcat", "Noun:\n- a cat and a dog");
+            writer.add_word("dog", "Noun:\n- a dog, that is not a cat's friend, nor a foe");
+            writer.add_word("summer", "Noun:\n- Été");
+            writer.save();
+        }
+
+        Reader reader{path};
+        auto words = [](const std::vector<Word>& r) {
+            std::vector<std::string> w;
+            for (const Word& word : r)
+                w.push_back(word.word);
+            return w;
+        };
+        CHECK(words(reader.search("cat", 10)) == std::vector<std::string>{"cat", "dogcat", "kitten", "dog"});
+        CHECK(words(reader.search("CAT", 2)) == std::vector<std::string>{"cat", "dogcat"});
+        CHECK(words(reader.search("dog cat", 1)) == std::vector<std::string>{"dogcat"});
+        CHECK(words(reader.search("\"domestic\" OR (animal*", 10)) == std::vector<std::string>{"kitten"});
+        CHECK(words(reader.search("Été", 10)) == std::vector<std::string>{"summer"});
+        CHECK(reader.search("été", 10).empty());
+        CHECK(reader.search("zebra", 10).empty());
+        CHECK(reader.search("", 10).empty());
+        CHECK(reader.search("cat", 0).empty());
+
+        std::vector<Word> r = reader.search("description 42", 3);
+        REQUIRE(r.size() == 3);
+        CHECK(r[0].word == "word42");
+        CHECK(r[0].description == "Noun:\n- description 42");
+        results.push_back(reader.search("a dog cat", 10));
+
+        CHECK_THROWS(Reader{plain_path}.search("cat", 10));
+    }
+    // same ranking in both formats
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].size() == results[1].size());
+    for (size_t i = 0; i < std::min(results[0].size(), results[1].size()); ++i)
+        CHECK(results[0][i].word == results[1][i].word);
+}
+
+TEST_CASE("dict_reader_native_empty") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "empty.dict").string();
+
+    Writer{path, Format::native, true}.save();
+    CHECK(!Reader{path}.find_description("word"));
+    CHECK(Reader{path}.search("word", 10).empty());
+}
+
+}  // namespace komankondi::dict
@@ -0,0 +1,58 @@
+#include "dict/writer.hpp"
+
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/reader.hpp"
+#include "dict/word.hpp"
+#include "temp_directory.hpp"
+#include "utils/database.hpp"
+
+namespace komankondi::dict {
+
+TEST_CASE("dict_writer") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "test.dict").string();
+
+    std::vector<Word> words;
+    for (int i = 0; i < 150; ++i)
+        words.push_back({fmt::format("word{}", i), fmt::format("description {}", i)});
+    words.push_back(words[10]);
+
+    {
+        Writer writer{path};
+        writer.add_word("first", "description");
+        CHECK_THROWS(writer.add_word("first", "again"));
+        CHECK(writer.add_words(words) == 150);
+        writer.save();
+    }
+    CHECK(!std::filesystem::exists(path + ".new"));
+
+    {
+        Database db{path, true};
+        CHECK(db.exec<std::tuple<int>>("SELECT max(rowid) FROM word") == std::tuple{151});
+        CHECK(db.exec<std::tuple<std::string>>("SELECT word FROM word WHERE rowid=1") == std::tuple{"first"});
+        CHECK(db.exec<std::tuple<int>>("SELECT COUNT() FROM sqlite_master WHERE type='index' AND tbl_name='word'") == std::tuple{1});
+        CHECK(db.exec<std::tuple<int>>("SELECT COUNT() FROM compression") == std::tuple{1});
+    }
+    {
+        Reader reader{path};
+        CHECK(reader.find_description("first") == "description");
+        CHECK(reader.find_description("word149") == "description 149");
+    }
+
+    // an unsaved writer leaves the previous dictionary untouched
+    {
+        Writer writer{path};
+        writer.add_words(words);
+    }
+    CHECK(!std::filesystem::exists(path + ".new"));
+    CHECK(Database{path, true}.exec<std::tuple<int>>("SELECT COUNT() FROM word") == std::tuple{151});
+}
+
+}  // namespace komankondi::dict
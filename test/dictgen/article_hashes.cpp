@@ -0,0 +1,67 @@
+#include "dictgen/article_hashes.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "temp_directory.hpp"
+#include "utils/file.hpp"
+#include "utils/hasher.hpp"
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_article_hashes") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "test.dict.hashes").string();
+
+    CHECK(!ArticleHashes::load(path, "0123456789abcdef"));
+
+    Hasher hasher{"sha256"};
+    CHECK(hash64(hasher, "article") == hash64(hasher, "article"));
+    CHECK(hash64(hasher, "article") != hash64(hasher, "articles"));
+
+    ArticleHashes hashes;
+    for (int i = 1000; i > 0; --i)
+        hashes.add({static_cast<uint64_t>(i) * 7919, static_cast<uint64_t>(i), i % 3 == 0});
+    hashes.save(path, "0123456789abcdef");
+    CHECK(!std::filesystem::exists(path + ".new"));
+
+    CHECK(!ArticleHashes::load(path, "fedcba9876543210"));
+
+    std::optional<ArticleHashes> loaded = ArticleHashes::load(path, "0123456789abcdef");
+    REQUIRE(loaded);
+    CHECK(loaded->size() == 1000);
+    const ArticleHash* hash = loaded->find(300 * 7919);
+    REQUIRE(hash);
+    CHECK(hash->content == 300);
+    CHECK(hash->has_word);
+    CHECK(!loaded->find(301 * 7919)->has_word);
+    CHECK(!loaded->find(1));
+    CHECK(!loaded->find(1001 * 7919));
+
+    // damaged files only make all articles get extracted again
+    SECTION("truncated") {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        CHECK(!ArticleHashes::load(path, "0123456789abcdef"));
+    }
+    SECTION("too many articles") {
+        std::vector<char> data = File{path, File::Mode::read | File::Mode::binary}.read<char>(1 << 20);
+        uint64_t nr_articles = uint64_t{1} << 60;
+        std::memcpy(data.data() + 8 + 16, &nr_articles, sizeof(nr_articles));
+        File{path, File::Mode::truncate | File::Mode::binary}.write<char>(data);
+        CHECK(!ArticleHashes::load(path, "0123456789abcdef"));
+    }
+    SECTION("invalid header") {
+        File{path, File::Mode::truncate | File::Mode::binary}.write(std::span{std::string_view{"garbage"}});
+        CHECK(!ArticleHashes::load(path, "0123456789abcdef"));
+    }
+}
+
+}  // namespace komankondi::dictgen
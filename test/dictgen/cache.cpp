@@ -0,0 +1,81 @@
+#include "dictgen/cache.hpp"
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "temp_directory.hpp"
+#include "utils/file.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+std::string read_all(const std::string& path) {
+    std::vector<char> data = File{path, File::Mode::read | File::Mode::binary}.read<char>();
+    return {data.begin(), data.end()};
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_cacher") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "sub" / "dump.tgz").string();
+
+    {
+        Cacher cacher{path};
+        CHECK(cacher.kept_size() == 0);
+        cacher.begin(0, "\"v1\"");
+        cacher.write(std::span{std::string_view{"hello "}});
+    }
+    CHECK(!std::filesystem::exists(path));
+    CHECK(std::filesystem::exists(path + ".new"));
+
+    SECTION("resume") {
+        {
+            Cacher cacher{path};
+            CHECK(cacher.kept_size() == 6);
+            CHECK(cacher.kept_validator() == "\"v1\"");
+            CHECK(read_all(path + ".new") == "hello ");
+            cacher.begin(6, "\"v1\"");
+            cacher.write(std::span{std::string_view{"world"}});
+            cacher.save();
+            cacher.save();
+        }
+        CHECK(read_all(path) == "hello world");
+        CHECK(!std::filesystem::exists(path + ".new"));
+        CHECK(!std::filesystem::exists(path + ".new.validator"));
+    }
+
+    SECTION("restart") {
+        {
+            Cacher cacher{path};
+            cacher.begin(0, "\"v2\"");
+            cacher.write(std::span{std::string_view{"new"}});
+        }
+        {
+            Cacher cacher{path};
+            CHECK(cacher.kept_size() == 3);
+            CHECK(cacher.kept_validator() == "\"v2\"");
+            CHECK_THROWS(cacher.begin(4, "\"v2\""));
+            cacher.begin(3, "\"v2\"");
+            cacher.save();
+        }
+        CHECK(read_all(path) == "new");
+    }
+
+    SECTION("no validator") {
+        {
+            Cacher cacher{path};
+            cacher.begin(6, "");
+        }
+        Cacher cacher{path};
+        CHECK(cacher.kept_size() == 0);
+    }
+}
+
+}  // namespace komankondi::dictgen
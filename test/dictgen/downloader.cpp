@@ -0,0 +1,115 @@
+#include "dictgen/downloader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+#include <httplib.h>
+
+#include "utils/buffer_pool.hpp"
+#include "utils/scope_exit.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+std::string read_all(Downloader& downloader) {
+    std::string r;
+    while (std::optional<BufferPool::Buffer> data = downloader.read())
+        std::transform((*data)->begin(), (*data)->end(), std::back_inserter(r), [](std::byte c) { return static_cast<char>(c); });
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_downloader") {
+    std::string content;
+    for (int i = 0; i < 2000000; ++i)
+        content += fmt::format("{} ", i);
+    std::string etag = "\"v1\"";
+
+    // serves ranges only while If-Range matches the current version, like dumps.wikimedia.org
+    httplib::Server server;
+    server.Get("/dump", [&](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("ETag", etag);
+        res.set_header("Accept-Ranges", "bytes");
+        if (req.has_header("If-Range") && req.get_header_value("If-Range") != etag)
+            res.status = 200;
+        res.set_content(content, "application/octet-stream");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread server_thread{[&] { server.listen_after_bind(); }};
+    ScopeExit server_stopper{[&] {
+        server.stop();
+        server_thread.join();
+    }};
+    server.wait_until_ready();
+    std::string origin = fmt::format("http://127.0.0.1:{}", port);
+
+    BufferPool pool;
+    int64_t offset = 1234;
+
+    SECTION("full") {
+        Downloader downloader{origin, "/dump", pool};
+        CHECK(downloader.headers().offset == 0);
+        CHECK(downloader.headers().validator == etag);
+        CHECK(read_all(downloader) == content);
+    }
+
+    SECTION("resume") {
+        Downloader downloader{origin, "/dump", pool, offset, etag};
+        CHECK(downloader.headers().offset == offset);
+        CHECK(downloader.headers().validator == etag);
+        CHECK(read_all(downloader) == content.substr(offset));
+    }
+
+    SECTION("resume complete") {
+        Downloader downloader{origin, "/dump", pool, std::ssize(content), etag};
+        CHECK(downloader.headers().offset == std::ssize(content));
+        CHECK(read_all(downloader).empty());
+    }
+
+    SECTION("changed") {
+        Downloader downloader{origin, "/dump", pool, offset, "\"v0\""};
+        CHECK(downloader.headers().offset == 0);
+        CHECK(downloader.headers().validator == etag);
+        CHECK(read_all(downloader) == content);
+    }
+
+    SECTION("parallel") {
+        REQUIRE(std::ssize(content) > 3 * Downloader::segment_size);
+        Downloader downloader{origin, "/dump", pool, 0, "", 4};
+        CHECK(downloader.headers().offset == 0);
+        CHECK(downloader.headers().validator == etag);
+        CHECK(read_all(downloader) == content);
+    }
+
+    SECTION("parallel resume") {
+        Downloader downloader{origin, "/dump", pool, offset, etag, 2};
+        CHECK(downloader.headers().offset == offset);
+        CHECK(read_all(downloader) == content.substr(offset));
+    }
+
+    SECTION("parallel changed") {
+        Downloader downloader{origin, "/dump", pool, offset, "\"v0\"", 2};
+        CHECK(downloader.headers().offset == 0);
+        CHECK(read_all(downloader) == content);
+    }
+
+    SECTION("not found") {
+        Downloader downloader{origin, "/missing", pool};
+        CHECK_THROWS(downloader.headers());
+    }
+
+    SECTION("parallel not found") {
+        Downloader downloader{origin, "/missing", pool, 0, "", 4};
+        CHECK_THROWS(downloader.headers());
+        CHECK_THROWS(downloader.read());
+    }
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,153 @@
+#include "dictgen/gzip.hpp"
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+#include <range/v3/range/conversion.hpp>
+#include <tbb/task_arena.h>
+#include <zlib.h>
+
+#include "dictgen/parallel_gzip.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+std::vector<std::byte> make_text(int nr_words) {
+    std::vector<std::string> vocabulary;
+    for (int i = 0; i < 5000; ++i)
+        vocabulary.push_back(fmt::format("w{}o{}rd", i * 7919 % 1000, i));
+
+    std::string r;
+    unsigned state = 1;
+    for (int i = 0; i < nr_words; ++i) {
+        state = state * 1103515245 + 12345;
+        r += vocabulary[(state >> 8) % vocabulary.size()];
+        r += (state >> 4) % 16 == 0 ? '\n' : ' ';
+    }
+    return std::as_bytes(std::span{r}) | ranges::to<std::vector>;
+}
+
+std::vector<std::byte> compress(std::span<const std::byte> data, int level) {
+    z_stream stream{};
+    REQUIRE(deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    std::vector<std::byte> r(deflateBound(&stream, data.size()));
+    stream.next_in = const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<unsigned char*>(r.data());
+    stream.avail_out = r.size();
+    REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    r.resize(stream.total_out);
+    deflateEnd(&stream);
+    return r;
+}
+
+template <typename Decompressor>
+std::vector<std::byte> decompress(Decompressor& unzip, std::span<const std::byte> data, int input_size) {
+    std::vector<std::byte> r;
+    for (size_t offset = 0; offset < data.size(); offset += input_size)
+        unzip(data.subspan(offset, std::min<size_t>(input_size, data.size() - offset)), r);
+    unzip({}, r);
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_gzip") {
+    std::vector<std::byte> text = make_text(300'000);
+    std::vector<std::byte> compressed = compress(text, 6);
+
+    std::vector<std::byte> members = compressed;
+    members.insert(members.end(), compressed.begin(), compressed.end());
+    std::vector<std::byte> expected = text;
+    expected.insert(expected.end(), text.begin(), text.end());
+
+    for (GzipBackend backend : gzip_backends()) {
+        INFO(fmt::to_string(backend));
+        GzipDecompressor unzip{backend};
+        CHECK(decompress(unzip, compressed, 65536) == text);
+        CHECK(unzip.finished());
+
+        GzipDecompressor unzip_members{backend};
+        CHECK(decompress(unzip_members, members, 65536) == expected);
+        CHECK(unzip_members.finished());
+    }
+}
+
+TEST_CASE("dictgen_gzip_flush") {
+    std::vector<std::byte> text = make_text(1000);
+    std::vector<std::byte> compressed = compress(text, 6);
+
+    for (GzipBackend backend : gzip_backends()) {
+        INFO(fmt::to_string(backend));
+        // flushing again, or without any data, gives nothing more
+        GzipDecompressor unzip{backend};
+        std::vector<std::byte> out = decompress(unzip, compressed, 65536);
+        unzip({}, out);
+        CHECK(out == text);
+        CHECK(unzip.finished());
+
+        GzipDecompressor unzip_empty{backend};
+        out.clear();
+        unzip_empty({}, out);
+        unzip_empty({}, out);
+        CHECK(out.empty());
+
+        if (backend == GzipBackend::libdeflate) {
+            GzipDecompressor unzip_truncated{backend};
+            unzip_truncated(std::span{compressed}.first(10), out);
+            CHECK_THROWS(unzip_truncated({}, out));
+        }
+    }
+}
+
+TEST_CASE("dictgen_gzip_parallel") {
+    std::vector<std::byte> text = make_text(300'000);
+
+    tbb::task_arena arena{8};  // force speculative decoding even with few cores
+    arena.execute([&] {
+        for (int level : {0, 1, 6, 9}) {
+            std::vector<std::byte> compressed = compress(text, level);
+            for (int chunk_size : {4096, 65536, ParallelGzipDecompressor::default_chunk_size}) {
+                ParallelGzipDecompressor unzip{chunk_size};
+                CHECK(decompress(unzip, compressed, 10000) == text);
+                CHECK(unzip.finished());
+            }
+        }
+    });
+}
+
+TEST_CASE("dictgen_gzip_parallel_members") {
+    std::vector<std::byte> text = make_text(50'000);
+    std::vector<std::byte> compressed = compress(text, 6);
+    compressed.insert(compressed.end(), compressed.begin(), compressed.end());
+    std::vector<std::byte> expected = text;
+    expected.insert(expected.end(), text.begin(), text.end());
+
+    ParallelGzipDecompressor unzip{4096};
+    CHECK(decompress(unzip, compressed, 1000) == expected);
+    CHECK(unzip.finished());
+}
+
+TEST_CASE("dictgen_gzip_parallel_truncated") {
+    std::vector<std::byte> compressed = compress(make_text(50'000), 6);
+    compressed.resize(compressed.size() - 100);
+
+    ParallelGzipDecompressor unzip{4096};
+    decompress(unzip, compressed, 1000);
+    CHECK(!unzip.finished());
+}
+
+TEST_CASE("dictgen_gzip_parallel_corrupted") {
+    std::vector<std::byte> compressed = compress(make_text(50'000), 6);
+    compressed[compressed.size() - 6] ^= std::byte{0xff};  // in trailer size
+
+    ParallelGzipDecompressor unzip{4096};
+    CHECK_THROWS(decompress(unzip, compressed, 1000));
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,64 @@
+#include "dictgen/html.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi::dictgen {
+namespace {
+
+std::string html_text(std::string_view html) {
+    std::string r = "- ";
+    append_html_text(html, r);
+    return r;
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_html_tokenizer") {
+    HtmlTokenizer tokenizer{R"(a<b id="x>y" class=z>c<!-- <d> --></b> 1 < 2<br/>)"};
+
+    std::optional<HtmlTag> tag = tokenizer.next();
+    REQUIRE(tag);
+    CHECK(tag->name == "b");
+    CHECK(!tag->closing);
+    CHECK(tag->begin == 1);
+    CHECK(tag->end == 21);
+    CHECK(tag->attribute("id") == "x>y");
+    CHECK(tag->attribute("class") == "z");
+    CHECK(!tag->attribute("title"));
+
+    tag = tokenizer.next();
+    REQUIRE(tag);
+    CHECK(tag->name == "b");
+    CHECK(tag->closing);
+
+    tag = tokenizer.next();
+    REQUIRE(tag);
+    CHECK(tag->name == "br");
+
+    CHECK(!tokenizer.next());
+}
+
+TEST_CASE("dictgen_html_text") {
+    CHECK(html_text("") == "- ");
+    CHECK(html_text("plain") == "- plain");
+    CHECK(html_text(R"(<a href="x">link</a> and <i>italic</i>)") == "- link and italic");
+    CHECK(html_text("&amp;&lt;&gt;&quot;&#39;&#8217;&#x2019;&nbsp;&ndash;") == "- &<>\"'’’\u00a0–");
+    CHECK(html_text("a & b &unknown; &#0; &#xzz; &amp") == "- a & b &unknown; &#0; &#xzz; &amp");
+    CHECK(html_text("1 < 2") == "- 1 < 2");
+
+    // long enough for vectorized scanning, with markup on both sides of 32 bytes boundaries
+    std::string html;
+    std::string expected = "- ";
+    for (int i = 0; i < 100; ++i) {
+        html += std::string(i % 37, 'x') + "<b>&amp;</b>";
+        expected += std::string(i % 37, 'x') + "&";
+    }
+    CHECK(html_text(html) == expected);
+}
+
+}  // namespace komankondi::dictgen
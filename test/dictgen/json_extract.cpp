@@ -0,0 +1,67 @@
+#include "dictgen/json_extract.hpp"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_json_extract") {
+    JsonStorage storage;
+
+    std::string_view json = R"({"name":"word","identifier":12,"abstract":null,"version":{"editor":{"name":"nope"},"tags":["a","}"]},)"
+                            R"("article_body":{"wikitext":"x","html":"<p>text</p>"},"license":[{"name":"CC"}]})";
+    JsonArticle article = extract_article(json, storage);
+    CHECK(article.name == "word");
+    CHECK(article.html == "<p>text</p>");
+    CHECK(article.html.data() >= json.data());
+    CHECK(article.html.data() < json.data() + json.size());
+    CHECK(storage.empty());
+
+    article = extract_article(R"( { "article_body" : { "html" : "<a href=\"x\">é😀\\</a>\n" } , "name" : "l’eau" } )", storage);
+    CHECK(article.name == "l’eau");
+    CHECK(article.html == "<a href=\"x\">é\U0001F600\\</a>\n");
+    CHECK(storage.size() == 1);  // name has no escape sequence
+}
+
+TEST_CASE("dictgen_json_extract_errors") {
+    JsonStorage storage;
+    CHECK_THROWS(extract_article(R"({"name":"word"})", storage));
+    CHECK_THROWS(extract_article(R"({"article_body":{"html":""}})", storage));
+    CHECK_THROWS(extract_article(R"({"name":"word)", storage));
+    CHECK_THROWS(extract_article(R"({"name":"\q","article_body":{"html":""}})", storage));
+    CHECK_THROWS(extract_article(R"(["name"])", storage));
+}
+
+TEST_CASE("dictgen_json_extract_batch") {
+    JsonStorage storage;
+    std::vector<JsonArticle> articles = extract_articles("{\"name\":\"a\",\"article_body\":{\"html\":\"1\"}}\n"
+                                                         "\n"
+                                                         "{\"name\":\"b\\\"\",\"article_body\":{\"html\":\"2\"}}\n",
+                                                         storage);
+    REQUIRE(articles.size() == 2);
+    CHECK(articles[0].name == "a");
+    CHECK(articles[0].html == "1");
+    CHECK(articles[1].name == "b\"");
+    CHECK(articles[1].html == "2");
+}
+
+TEST_CASE("dictgen_json_extract_split_lines") {
+    std::vector<std::string_view> lines = {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\n", "b\n", "c\n", "d\n", "e\n", "f\n", "g"};
+    std::vector<std::span<const std::string_view>> batches = split_lines(lines, 20, 4);
+    REQUIRE(batches.size() == 3);
+    CHECK(batches[0].data() == &lines[0]);
+    CHECK(batches[0].size() == 1);
+    CHECK(batches[1].data() == &lines[1]);
+    CHECK(batches[1].size() == 4);
+    CHECK(batches[2].data() == &lines[5]);
+    CHECK(batches[2].size() == 2);
+
+    CHECK(split_lines(lines, 1000, 4).size() == 1);
+    CHECK(split_lines(lines, 1, 0).size() == lines.size());
+    CHECK(split_lines({}, 1, 0).empty());
+}
+
+}  // namespace komankondi::dictgen
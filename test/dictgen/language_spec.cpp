@@ -0,0 +1,54 @@
+#include "dictgen/language_spec.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_parse_article") {
+    LanguageSpec english = find_language_spec("eng");
+    std::string_view html = R"(<h2 id="Dutch">Dutch</h2><h3 id="Noun">Noun</h3><ol><li>wrong</li></ol>)"
+                            R"(<h2 id="English">English</h2>)"
+                            R"(<h3 id="Etymology">Etymology</h3><p>From <i>x</i>.</p>)"
+                            R"(<h3 id="Noun"><span>Noun</span></h3><p>word</p>)"
+                            "<ol><li>first <a href=\"x\">sense</a>\n<dl><dd>example</dd></dl>\n<ul><li>quotation</li></ul></li>"
+                            "<li>second<ol><li>sub</li></ol></li></ol>"
+                            R"(<h4 id="Synonyms">Synonyms</h4><ul><li>syn</li></ul>)"
+                            R"(<h3 id="Verb_2">Verb</h3><ol><li>to do</li></ol>)"
+                            R"(<h2 id="French">French</h2><h3 id="Noun">Noun</h3><ol><li>wrong</li></ol>)";
+
+    std::vector<ArticleForm> forms = parse_article(html, english);
+    REQUIRE(forms.size() == 2);
+    CHECK(forms[0].name == "Noun");
+    CHECK(forms[0].definitions == std::vector<std::string_view>{"first <a href=\"x\">sense</a>", "second", "sub"});
+    CHECK(forms[1].name == "Verb");
+    CHECK(forms[1].definitions == std::vector<std::string_view>{"to do"});
+
+    CHECK(parse_article(R"(<h2 id="French">French</h2><h3 id="Noun">Noun</h3><ol><li>x</li></ol>)", english).empty());
+    CHECK(parse_article(R"(<h2 id="English_language">English</h2><h3 id="Noun">Noun</h3><ol><li>x</li></ol>)", english).empty());
+    CHECK(parse_article(R"(<h2 id="English">English</h2><h3 id="Etymology">Etymology</h3>)", english).empty());
+}
+
+TEST_CASE("dictgen_parse_article_skip_markers") {
+    LanguageSpec french = find_language_spec("fr");
+    std::string html = R"(<h2 id="Français">Français</h2><h3 id="Nom_commun">Nom commun</h3><ol><li>définition</li></ol>)";
+    REQUIRE(parse_article(html, french).size() == 1);
+    CHECK(parse_article(html, french)[0].name == "Nom commun");
+
+    html += R"(<a href="./Modèle:mercihabitants">)";
+    CHECK(parse_article(html, french).empty());
+}
+
+TEST_CASE("dictgen_language_spec_hash") {
+    LanguageSpec spec = find_language_spec("french");
+    CHECK(hash(spec) == hash(find_language_spec("french")));
+    CHECK(hash(spec).size() == 16);
+    CHECK(hash(spec) != hash(find_language_spec("english")));
+    spec.skip_markers.push_back("marker");
+    CHECK(hash(spec) != hash(find_language_spec("french")));
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,69 @@
+#include "dictgen/line_splitter.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/buffer_pool.hpp"
+
+namespace komankondi::dictgen {
+namespace {
+
+std::span<const std::byte> bytes(std::string_view str) {
+    return std::as_bytes(std::span{str});
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_line_splitter") {
+    BufferPool pool;
+    LineSplitter splitter{pool};
+    LineSplitter::Lines lines;
+
+    std::string_view first = "one\ntwo\nthr";
+    std::string_view second = "ee";
+    std::string_view third = "\nfour\nfive\n";
+    splitter(bytes(first), lines);
+    CHECK(!splitter.finished());
+    splitter(bytes(second), lines);
+    splitter(bytes(third), lines);
+    CHECK(splitter.finished());
+
+    CHECK(lines.lines == std::vector<std::string_view>{"one\n", "two\n", "three\n", "four\n", "five\n"});
+    // only the line straddling pieces is copied
+    CHECK(lines.lines[0].data() == first.data());
+    CHECK(lines.lines[1].data() == first.data() + 4);
+    CHECK(lines.lines[3].data() == third.data() + 1);
+    CHECK(lines.copies.size() == 1);
+
+    LineSplitter::Lines more;
+    splitter(bytes("six"), more);
+    splitter(bytes(""), more);
+    CHECK(more.lines.empty());
+    CHECK(!splitter.finished());
+    splitter(bytes("\n"), more);
+    CHECK(more.lines == std::vector<std::string_view>{"six\n"});
+
+    LineSplitter::Lines last;
+    splitter.finish(last);
+    CHECK(last.lines.empty());
+    splitter(bytes("seven\neight"), last);
+    splitter.finish(last);
+    CHECK(splitter.finished());
+    CHECK(last.lines == std::vector<std::string_view>{"seven\n", "eight"});
+
+    // lines longer than pieces
+    std::string long_line(100'000, 'x');
+    long_line += '\n';
+    LineSplitter::Lines long_lines;
+    for (size_t offset = 0; offset < long_line.size(); offset += 1000)
+        splitter(bytes(std::string_view{long_line}.substr(offset, 1000)), long_lines);
+    CHECK(splitter.finished());
+    CHECK(long_lines.lines == std::vector<std::string_view>{long_line});
+}
+
+}  // namespace komankondi::dictgen
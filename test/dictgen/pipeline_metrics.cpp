@@ -0,0 +1,58 @@
+#include "dictgen/pipeline_metrics.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "temp_directory.hpp"
+#include "utils/file.hpp"
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_pipeline_metrics") {
+    PipelineMetrics metrics;
+    for (int i = 0; i < 3; ++i) {
+        PipelineMetrics::Timer timer{metrics, PipelineStage::gzip, 100};
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        timer.done(400);
+    }
+    {
+        // not done, e.g. because of an exception
+        PipelineMetrics::Timer timer{metrics, PipelineStage::gzip, 100};
+    }
+
+    PipelineMetrics::Stats gzip = metrics.stats(PipelineStage::gzip);
+    CHECK(gzip.items == 3);
+    CHECK(gzip.bytes_in == 400);
+    CHECK(gzip.bytes_out == 1200);
+    CHECK(gzip.busy >= 0.03);
+    CHECK(gzip.busy <= metrics.elapsed());
+    CHECK(gzip.utilization > 0);
+    CHECK(gzip.utilization <= 1);
+    CHECK(metrics.stats(PipelineStage::parse).items == 0);
+
+    std::string json = metrics.to_json();
+    CHECK(json.find(R"("gzip":{"items":3,"bytes_in":400,"bytes_out":1200,)") != std::string::npos);
+    CHECK(json.find(R"("write":{"items":0,)") != std::string::npos);
+
+    std::string prometheus = metrics.to_prometheus();
+    CHECK(prometheus.find("# TYPE komankondi_dictgen_stage_items_total counter\n") != std::string::npos);
+    CHECK(prometheus.find("komankondi_dictgen_stage_bytes_out_total{stage=\"gzip\"} 1200\n") != std::string::npos);
+    CHECK(prometheus.find("komankondi_dictgen_stage_items_total{stage=\"fetch\"} 0\n") != std::string::npos);
+
+    TempDirectory dir;
+    for (std::string name : {"metrics.json", "metrics.prom"}) {
+        std::string path = (dir.path() / name).string();
+        metrics.save(path);
+        metrics.save(path);
+        std::vector<char> content = File{path, File::Mode::read}.read<char>();
+        CHECK(content.front() == (name.ends_with(".json") ? '{' : '#'));
+        CHECK(!std::filesystem::exists(path + ".new"));
+    }
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,60 @@
+#include "dictgen/synthetic_dump.hpp"
+
+#include <algorithm>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dictgen/gzip.hpp"
+#include "dictgen/json_extract.hpp"
+#include "dictgen/language_spec.hpp"
+#include "dictgen/tarcat.hpp"
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_synthetic_dump") {
+    SyntheticDumpOptions options;
+    options.nr_articles = 3000;
+    options.duplicate_share = 0.05;
+    SyntheticDump dump = make_synthetic_dump(options);
+    CHECK(make_synthetic_dump(options).archive == dump.archive);
+
+    GzipDecompressor unzip;
+    std::vector<std::byte> tar = unzip(dump.archive);
+    CHECK(unzip.finished());
+    // odd slices, for tar headers and padding to straddle them
+    TarCat tarcat;
+    std::vector<std::byte> json;
+    for (size_t offset = 0; offset < tar.size(); offset += 1000)
+        tarcat(std::span{tar}.subspan(offset, std::min<size_t>(1000, tar.size() - offset)), json);
+    CHECK(tarcat.finished());
+    CHECK(std::ssize(json) == dump.json_size);
+
+    JsonStorage storage;
+    std::vector<JsonArticle> articles = extract_articles({reinterpret_cast<const char*>(json.data()), json.size()}, storage);
+    std::set<std::string_view> names;
+    for (const JsonArticle& article : articles)
+        names.insert(article.name);
+    CHECK(std::ssize(names) == options.nr_articles);
+    CHECK(std::ssize(articles) > options.nr_articles);
+
+    for (std::string_view language : {"english", "french"}) {
+        LanguageSpec language_spec = find_language_spec(language);
+        std::set<std::string_view> words;
+        for (const JsonArticle& article : articles) {
+            std::vector<ArticleForm> forms = parse_article(article.html, language_spec);
+            if (forms.empty())
+                continue;
+            words.insert(article.name);
+            CHECK(std::all_of(forms.begin(), forms.end(), [](const ArticleForm& form) { return !form.definitions.empty(); }));
+        }
+        CHECK(std::ssize(words) == dump.nr_articles[language_spec.section_id]);
+        CHECK(words.size() > 0);
+    }
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,133 @@
+#include "dictgen/tarcat.hpp"
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+namespace komankondi::dictgen {
+namespace {
+
+struct Header {
+    std::string_view name;
+    char type = '0';
+    std::string_view prefix = {};
+    std::string_view magic = "ustar";
+    bool base256_size = false;
+};
+
+void append_member(std::vector<std::byte>& tar, const Header& header, std::string_view content) {
+    std::vector<std::byte> block(512);
+    auto set_field = [&](size_t offset, std::string_view value) { std::copy(value.begin(), value.end(), reinterpret_cast<char*>(block.data()) + offset); };
+    set_field(0, header.name);
+    if (header.base256_size) {
+        block[124] = std::byte{0x80};
+        for (size_t i = 0; i < 8; ++i)
+            block[135 - i] = static_cast<std::byte>(content.size() >> (8 * i));
+    }
+    else {
+        set_field(124, fmt::format("{:011o}", content.size()));
+    }
+    block[156] = static_cast<std::byte>(header.type);
+    set_field(257, header.magic);
+    set_field(345, header.prefix);
+    tar.insert(tar.end(), block.begin(), block.end());
+    std::span<const std::byte> bytes = std::as_bytes(std::span{content});
+    tar.insert(tar.end(), bytes.begin(), bytes.end());
+    tar.resize((tar.size() + 511) / 512 * 512);
+}
+
+std::string pax_record(std::string_view key, std::string_view value) {
+    std::string record = fmt::format(" {}={}\n", key, value);
+    std::string length = std::to_string(record.size() + 2);
+    if (length.size() + record.size() != std::stoul(length))
+        length = std::to_string(record.size() + length.size());
+    return length + record;
+}
+
+std::string as_string(std::span<const std::byte> data) {
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+}  // namespace
+
+
+TEST_CASE("dictgen_tarcat") {
+    std::string long_name = std::string(150, 'n') + ".ndjson";
+    std::string pax_content = pax_record("mtime", "1704067200.5") + pax_record("path", "pax/" + long_name);
+
+    std::vector<std::byte> tar;
+    append_member(tar, {"dir/", '5'}, "");
+    append_member(tar, {"a.ndjson"}, std::string(1000, 'a'));
+    append_member(tar, {"empty.ndjson"}, "");
+    append_member(tar, {"././@LongLink", 'L', {}, "ustar  "}, long_name + '\0');
+    append_member(tar, {"truncated", '0', {}, "ustar  "}, std::string(512, 'b'));
+    append_member(tar, {"PaxHeaders/x", 'x'}, pax_content);
+    append_member(tar, {"ignored"}, std::string(3, 'c'));
+    append_member(tar, {"link", '2'}, "");
+    append_member(tar, {"d.ndjson", '0', "prefix"}, std::string(70000, 'd'));
+    append_member(tar, {"././@LongLink", 'L', {}, "ustar  "}, "k/" + long_name + '\0');
+    append_member(tar, {"././@LongLink", 'K', {}, "ustar  "}, std::string{"target"} + '\0');
+    append_member(tar, {"short", '0', {}, "ustar  "}, "ff");
+    append_member(tar, {"e.ndjson", '0', {}, "ustar", true}, "eeeee");
+    tar.resize(tar.size() + 2 * 512);
+
+    std::vector<TarCat::Member> expected_members = {
+            {"a.ndjson", 1000}, {"empty.ndjson", 0}, {long_name, 512}, {"pax/" + long_name, 3}, {"prefix/d.ndjson", 70000}, {"k/" + long_name, 2}, {"e.ndjson", 5}};
+    std::vector<std::string> expected_contents = {std::string(1000, 'a'), "", std::string(512, 'b'), std::string(3, 'c'), std::string(70000, 'd'), "ff", "eeeee"};
+
+    for (size_t slice_size : {1, 100, 511, 512, 513, 4096, 1 << 20}) {
+        INFO(slice_size);
+        TarCat copying;
+        TarCat viewing;
+        std::vector<std::byte> copied;
+        std::vector<TarCat::View> views;
+        for (size_t offset = 0; offset < tar.size(); offset += slice_size) {
+            std::span<const std::byte> slice = std::span{tar}.subspan(offset, std::min(slice_size, tar.size() - offset));
+            copying(slice, copied);
+            viewing.views(slice, views);
+        }
+        CHECK(copying.finished());
+        CHECK(viewing.finished());
+
+        std::string expected;
+        for (const std::string& content : expected_contents)
+            expected += content;
+        CHECK(as_string(copied) == expected);
+
+        REQUIRE(viewing.members().size() == expected_members.size());
+        for (size_t i = 0; i < expected_members.size(); ++i) {
+            CHECK(viewing.members()[i].name == expected_members[i].name);
+            CHECK(viewing.members()[i].size == expected_members[i].size);
+        }
+
+        std::vector<std::string> contents(expected_members.size());
+        int nr_ends = 0;
+        int last_member = 0;
+        for (const TarCat::View& view : views) {
+            if (!view.data.empty()) {
+                CHECK(view.data.data() >= tar.data());
+                CHECK(view.data.data() + view.data.size() <= tar.data() + tar.size());
+            }
+            CHECK(view.member >= last_member);
+            last_member = view.member;
+            contents[view.member] += as_string(view.data);
+            if (view.end) {
+                ++nr_ends;
+                CHECK(std::ssize(contents[view.member]) == expected_members[view.member].size);
+            }
+        }
+        CHECK(contents == expected_contents);
+        CHECK(nr_ends == std::ssize(expected_members));
+    }
+
+    TarCat truncated;
+    truncated(std::span{tar}.first(2000));
+    CHECK(!truncated.finished());
+}
+
+}  // namespace komankondi::dictgen
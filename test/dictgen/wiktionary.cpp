@@ -0,0 +1,108 @@
+#include "dictgen/wiktionary.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/reader.hpp"
+#include "dictgen/dump_host.hpp"
+#include "dictgen/language_spec.hpp"
+#include "dictgen/synthetic_dump.hpp"
+#include "temp_directory.hpp"
+#include "utils/database.hpp"
+#include "utils/path.hpp"
+#include "utils/scope_exit.hpp"
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_wiktionary") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "english.dict").string();
+
+    SyntheticDumpOptions dump_options;
+    dump_options.nr_articles = 5000;
+    SyntheticDump dump = make_synthetic_dump(dump_options);
+    // an older run, to check that the latest one is used
+    DumpHost host{{{"en", "20240101", make_synthetic_dump({.nr_articles = 10}).archive}, {"en", "20240201", dump.archive}}};
+
+    LanguageSpec english = find_language_spec("english");
+    GenerateOptions options;
+    options.cache = false;
+    options.dump_host = host.origin();
+
+    SECTION("single connection") {
+    }
+    SECTION("several connections") {
+        options.nr_connections = 3;
+    }
+    generate_dictionary(path, english, options);
+
+    Database db{path, true};
+    CHECK(db.exec<std::tuple<int>>("SELECT COUNT() FROM word") == std::tuple{dump.nr_articles["English"]});
+
+    // words are written in the order of the dump, whatever the threads do
+    std::string other_path = (dir.path() / "other.dict").string();
+    generate_dictionary(other_path, english, options);
+    std::string_view query = "SELECT group_concat(word, ' ') FROM (SELECT word FROM word ORDER BY rowid)";
+    CHECK(db.exec<std::tuple<std::string>>(query) == Database{other_path, true}.exec<std::tuple<std::string>>(query));
+    dict::Reader reader{path};
+    std::optional<std::string> description = reader.find_description(reader.pick_word().word);
+    REQUIRE(description);
+    CHECK(!description->empty());
+}
+
+TEST_CASE("dictgen_wiktionary_cache") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "english.dict").string();
+
+    // a date no real dump has, not to touch the cache of actual runs
+    std::string date = "19990101";
+    std::filesystem::path cache_dir = get_cache_directory();
+    auto remove_cache = [&](std::string_view extension) {
+        if (!std::filesystem::exists(cache_dir))
+            return;
+        std::string prefix = fmt::format("en_{}", date);
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{cache_dir}) {
+            std::string name = entry.path().filename().string();
+            if (name.starts_with(prefix) && name.ends_with(extension))
+                std::filesystem::remove(entry.path());
+        }
+    };
+    remove_cache("");
+    ScopeExit cache_remover{[&] { remove_cache(""); }};
+
+    SyntheticDump dump = make_synthetic_dump({.nr_articles = 1000});
+    DumpHost host{{{"en", date, dump.archive}}};
+
+    LanguageSpec english = find_language_spec("english");
+    GenerateOptions options;
+    options.cache = true;
+    options.dump_host = host.origin();
+    auto nr_words = [&] {
+        return Database{path, true}.exec<std::tuple<int>>("SELECT COUNT() FROM word");
+    };
+
+    // downloaded and saved
+    generate_dictionary(path, english, options);
+    CHECK(nr_words() == std::tuple{dump.nr_articles["English"]});
+    CHECK(std::filesystem::exists(cache_dir / fmt::format("en_{}.tgz", date)));
+    CHECK(!std::filesystem::exists(cache_dir / fmt::format("en_{}.tgz.new", date)));
+
+    // extracted again from the cached dump
+    remove_cache(".words");
+    std::filesystem::remove(path);
+    generate_dictionary(path, english, options);
+    CHECK(nr_words() == std::tuple{dump.nr_articles["English"]});
+
+    // replayed from the cached words
+    std::filesystem::remove(path);
+    generate_dictionary(path, english, options);
+    CHECK(nr_words() == std::tuple{dump.nr_articles["English"]});
+}
+
+}  // namespace komankondi::dictgen
@@ -0,0 +1,64 @@
+#include "dictgen/word_cache.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include "dict/word.hpp"
+#include "temp_directory.hpp"
+#include "utils/file.hpp"
+
+namespace komankondi::dictgen {
+
+TEST_CASE("dictgen_word_cache") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "words").string();
+
+    std::vector<dict::Word> words;
+    for (int i = 0; i < 50000; ++i)
+        words.push_back({fmt::format("word{}", i), fmt::format("Noun:\n- description {} with some more text\n\n", i)});
+
+    {
+        WordCacheWriter writer{path};
+        writer.add_words(std::span{words}.first(10));
+        writer.add_words(std::span{words}.subspan(10));
+    }
+    CHECK(!std::filesystem::exists(path));
+    CHECK(!std::filesystem::exists(path + ".new"));
+
+    {
+        WordCacheWriter writer{path};
+        writer.add_words(words);
+        writer.save();
+    }
+    CHECK(!std::filesystem::exists(path + ".new"));
+
+    WordCacheReader reader{path};
+    CHECK(reader.nr_frames() > 1);
+    std::vector<dict::Word> read;
+    for (int i = reader.nr_frames() - 1; i >= 0; --i) {
+        std::vector<dict::Word> frame = reader.read_frame(i);
+        read.insert(read.begin(), frame.begin(), frame.end());
+    }
+    REQUIRE(read.size() == words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        CHECK(read[i].word == words[i].word);
+        CHECK(read[i].description == words[i].description);
+    }
+
+    SECTION("empty") {
+        WordCacheWriter writer{path};
+        writer.save();
+        CHECK(WordCacheReader{path}.nr_frames() == 0);
+    }
+
+    SECTION("truncated") {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        CHECK_THROWS(WordCacheReader{path});
+    }
+}
+
+}  // namespace komankondi::dictgen
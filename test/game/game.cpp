@@ -0,0 +1,54 @@
+#include "game/game.hpp"
+
+#include <filesystem>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dict/format.hpp"
+#include "dict/writer.hpp"
+#include "temp_directory.hpp"
+
+namespace komankondi::game {
+
+TEST_CASE("game_tolerance") {
+    TempDirectory dir;
+    std::string path = (dir.path() / "test.dict").string();
+
+    {
+        dict::Writer writer{path, dict::Format::sqlite, false, true};
+        writer.add_word("kitten", "young cat");
+        writer.add_word("mitten", "glove");
+        writer.save();
+    }
+    Game game{path, 1, 1};
+    auto solution = [&] { return game.description() == "young cat" ? "kitten" : "mitten"; };
+
+    // the answer is not cut short while typed, even though its prefixes are within the tolerance
+    std::string word = solution();
+    for (size_t i = 1; i < word.size(); ++i)
+        CHECK(!game.type(word.substr(0, i)));
+    CHECK(!game.type(word + "s"));
+    CHECK(game.type(word));
+
+    word = solution();
+    Game::Answer answer = game.submit(word.substr(0, word.size() - 1));
+    CHECK(answer.correct);
+    CHECK(answer.distance == 1);
+
+    // another word of the dictionary is not a typo
+    word = solution();
+    std::string other = word == "kitten" ? "mitten" : "kitten";
+    answer = game.submit(other);
+    CHECK(!answer.correct);
+    CHECK(answer.near_words.empty());
+    answer = game.submit(other + "s");
+    CHECK(!answer.correct);
+    CHECK(answer.near_words == std::vector<std::string>{other});
+
+    answer = game.submit(word);
+    CHECK(answer.correct);
+    CHECK(answer.distance == 0);
+}
+
+}  // namespace komankondi::game
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include <fmt/core.h>
+
+namespace komankondi {
+
+/// Directory of a unique name in the temporary directory, removed with its content when destroyed,
+/// so that test and bench binaries can run in parallel.
+struct TempDirectory {
+    TempDirectory() {
+        std::random_device random;
+        do {
+            uint64_t id = static_cast<uint64_t>(random()) << 32 | random();
+            path_ = std::filesystem::temp_directory_path() / fmt::format("komankondi_{:016x}", id);
+        } while (!std::filesystem::create_directory(path_));
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+    TempDirectory(TempDirectory&&) noexcept = delete;
+    TempDirectory& operator=(TempDirectory&&) noexcept = delete;
+
+    const std::filesystem::path& path() const {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+}  // namespace komankondi
@@ -0,0 +1,43 @@
+#include "utils/buffer_pool.hpp"
+
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi {
+
+TEST_CASE("buffer_pool") {
+    BufferPool pool;
+    {
+        BufferPool::Buffer a = pool.get(1000);
+        CHECK(a->empty());
+        CHECK(a->capacity() >= 1000);
+        a->resize(1000);
+        const std::byte* data = a->data();
+
+        BufferPool::Buffer b = pool.get(10);
+        CHECK(pool.stats().in_use == 2);
+
+        a = {};
+        CHECK(pool.stats().in_use == 1);
+
+        BufferPool::Buffer c = pool.get(500);
+        CHECK(c->empty());
+        CHECK(c->data() == data);
+
+        BufferPool::Buffer d = std::move(c);
+        CHECK(pool.stats().in_use == 2);
+    }
+
+    BufferPool::Stats stats = pool.stats();
+    CHECK(stats.in_use == 0);
+    CHECK(stats.peak_in_use == 2);
+    CHECK(stats.allocated == 2);
+
+    // too big for recycled buffers
+    BufferPool::Buffer e = pool.get(5000);
+    CHECK(e->capacity() >= 5000);
+    CHECK(pool.stats().allocated == 3);
+}
+
+}  // namespace komankondi
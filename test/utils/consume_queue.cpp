@@ -0,0 +1,130 @@
+#include "utils/consume_queue.hpp"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi {
+namespace {
+
+template <QueueMode mode>
+struct Mode {
+    static constexpr QueueMode value = mode;
+};
+
+}  // namespace
+
+
+TEMPLATE_TEST_CASE("consume_queue", "", Mode<QueueMode::spsc>, Mode<QueueMode::mpmc>) {
+    ConsumeQueue<std::unique_ptr<int>, TestType::value> queue{3};
+    CHECK(!queue.try_pop());
+    for (int i = 0; i < 3; ++i)
+        CHECK(queue.push(std::make_unique<int>(i)));
+    CHECK(*queue.pop().value() == 0);
+    CHECK(queue.push(std::make_unique<int>(3)));
+    CHECK(*queue.try_pop().value() == 1);
+
+    queue.close();
+    CHECK(!queue.push(std::make_unique<int>(4)));
+    CHECK(*queue.pop().value() == 2);
+    CHECK(*queue.pop().value() == 3);
+    CHECK(!queue.pop());
+    CHECK(!queue.try_pop());
+}
+
+TEMPLATE_TEST_CASE("consume_queue_blocking", "", Mode<QueueMode::spsc>, Mode<QueueMode::mpmc>) {
+    constexpr int nr_elements = 100000;
+    for (int size : {1, 4}) {
+        INFO(size);
+        ConsumeQueue<int, TestType::value> queue{size};
+
+        std::future<int64_t> consumer = std::async(std::launch::async, [&] {
+            int64_t r = 0;
+            int expected = 0;
+            while (std::optional<int> element = queue.pop()) {
+                CHECK(*element == expected++);
+                r += *element;
+            }
+            return r;
+        });
+        for (int i = 0; i < nr_elements; ++i)
+            REQUIRE(queue.push(int{i}));
+        queue.close();
+        CHECK(consumer.get() == int64_t{nr_elements} * (nr_elements - 1) / 2);
+    }
+}
+
+TEST_CASE("consume_queue_mpmc") {
+    constexpr int nr_threads = 4;
+    constexpr int nr_elements = 50000;
+    ConsumeQueue<int, QueueMode::mpmc> queue{8};
+
+    std::vector<std::future<int64_t>> consumers;
+    for (int i = 0; i < nr_threads; ++i) {
+        consumers.push_back(std::async(std::launch::async, [&] {
+            int64_t r = 0;
+            while (std::optional<int> element = queue.pop())
+                r += *element;
+            return r;
+        }));
+    }
+    std::vector<std::future<void>> producers;
+    for (int i = 0; i < nr_threads; ++i) {
+        producers.push_back(std::async(std::launch::async, [&, i] {
+            for (int j = i; j < nr_elements; j += nr_threads)
+                REQUIRE(queue.push(int{j}));
+        }));
+    }
+    for (std::future<void>& producer : producers)
+        producer.get();
+    queue.close();
+
+    int64_t sum = 0;
+    for (std::future<int64_t>& consumer : consumers)
+        sum += consumer.get();
+    CHECK(sum == int64_t{nr_elements} * (nr_elements - 1) / 2);
+}
+
+TEMPLATE_TEST_CASE("consume_queue_close_during_push", "", Mode<QueueMode::spsc>, Mode<QueueMode::mpmc>) {
+    // every successful push is popped, even when racing with close
+    for (int i = 0; i < 200; ++i) {
+        ConsumeQueue<int, TestType::value> queue{4};
+        std::future<int> consumer = std::async(std::launch::async, [&] {
+            int r = 0;
+            while (queue.pop())
+                ++r;
+            return r;
+        });
+        std::future<int> producer = std::async(std::launch::async, [&] {
+            int r = 0;
+            while (queue.push(int{r}))
+                ++r;
+            return r;
+        });
+        for (int j = 0; j < i * 10; ++j)
+            std::this_thread::yield();
+        queue.close();
+        CHECK(producer.get() == consumer.get());
+    }
+}
+
+TEST_CASE("consume_queue_close_wakes") {
+    ConsumeQueue<int, QueueMode::spsc> queue{1};
+    std::future<std::optional<int>> consumer = std::async(std::launch::async, [&] { return queue.pop(); });
+    queue.close();
+    CHECK(!consumer.get());
+
+    ConsumeQueue<int, QueueMode::spsc> full{1};
+    REQUIRE(full.push(0));
+    std::future<bool> producer = std::async(std::launch::async, [&] { return full.push(1); });
+    full.close();
+    CHECK(!producer.get());
+}
+
+}  // namespace komankondi
@@ -0,0 +1,95 @@
+#include "utils/levenshtein.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/utf8.hpp"
+
+namespace komankondi {
+namespace {
+
+int naive_distance(const std::u32string& a, const std::u32string& b) {
+    std::vector<std::vector<int>> d(a.size() + 1, std::vector<int>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i)
+        d[i][0] = i;
+    for (size_t j = 0; j <= b.size(); ++j)
+        d[0][j] = j;
+    for (size_t i = 1; i <= a.size(); ++i) {
+        for (size_t j = 1; j <= b.size(); ++j)
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+    }
+    return d[a.size()][b.size()];
+}
+
+}  // namespace
+
+
+TEST_CASE("levenshtein_automaton") {
+    LevenshteinAutomaton automaton{"kitten", 2};
+    CHECK(automaton.distance("kitten") == 0);
+    CHECK(automaton.distance("sitten") == 1);
+    CHECK(automaton.distance("sittin") == 2);
+    CHECK(automaton.distance("sitting") == 3);
+    CHECK(automaton.distance("") == 3);
+    CHECK(automaton.distance("kittens") == 1);
+    CHECK(automaton.distance("itten") == 1);
+
+    // code points are edited, not bytes
+    CHECK(LevenshteinAutomaton{"été", 1}.distance("ete") == 2);
+    CHECK(LevenshteinAutomaton{"été", 1}.distance("eté") == 1);
+    CHECK(LevenshteinAutomaton{"", 1}.distance("é") == 1);
+
+    LevenshteinAutomaton::State state = automaton.start();
+    LevenshteinAutomaton::State next;
+    for (char c : std::string{"kit"}) {
+        automaton.step(state, c, next);
+        std::swap(state, next);
+    }
+    CHECK(automaton.can_match(state));
+    CHECK(automaton.distance(state) == 3);
+    for (char c : std::string{"xyz"}) {
+        automaton.step(state, c, next);
+        std::swap(state, next);
+    }
+    CHECK(!automaton.can_match(state));
+
+    CHECK_THROWS(LevenshteinAutomaton{"word", -1});
+}
+
+TEST_CASE("levenshtein_automaton_random") {
+    unsigned state = 1;
+    auto random_word = [&] {
+        std::string r;
+        state = state * 1103515245 + 12345;
+        for (unsigned i = (state >> 8) % 8; i > 0; --i) {
+            state = state * 1103515245 + 12345;
+            unsigned letter = (state >> 8) % 5;
+            r += letter == 4 ? "é" : std::string(1, static_cast<char>('a' + letter));
+        }
+        return r;
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+        std::string word = random_word();
+        std::string other = random_word();
+        int expected = naive_distance(decode_utf8(word), decode_utf8(other));
+        for (int max_distance : {0, 1, 2, 3}) {
+            INFO(word << " " << other << " " << max_distance);
+            CHECK(LevenshteinAutomaton{word, max_distance}.distance(other) == std::min(expected, max_distance + 1));
+        }
+    }
+}
+
+TEST_CASE("decode_utf8") {
+    CHECK(decode_utf8("aé€😀") == std::u32string{U'a', U'é', U'€', U'😀'});
+    // invalid bytes are taken one by one
+    CHECK(decode_utf8("a\xc3") == std::u32string{U'a', 0xc3});
+    CHECK(decode_utf8("\xc3z") == std::u32string{0xc3, U'z'});
+    CHECK(decode_utf8("\xc0\xaf") == std::u32string{0xc0, 0xaf});
+    CHECK(decode_utf8("\xed\xa0\x80") == std::u32string{0xed, 0xa0, 0x80});
+}
+
+}  // namespace komankondi
@@ -0,0 +1,51 @@
+#include "utils/newlines.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace komankondi {
+
+TEST_CASE("newlines") {
+    std::string text;
+    std::vector<size_t> expected;
+    unsigned state = 1;
+    for (int i = 0; i < 1000; ++i) {
+        state = state * 1103515245 + 12345;
+        if ((state >> 8) % 7 == 0) {
+            expected.push_back(text.size());
+            text += '\n';
+        }
+        else {
+            text += static_cast<char>('\n' + 1 + (state >> 16) % 100);
+        }
+    }
+
+    // every alignment and length of the vectorised part and of the rest
+    for (size_t begin : {0, 1, 31, 32, 33, 127, 128, 129}) {
+        for (size_t end : {text.size(), text.size() - 1, text.size() - 31, text.size() - 127, begin + 130, begin + 5, begin}) {
+            std::vector<size_t> r = {42};
+            find_newlines(std::string_view{text}.substr(begin, end - begin), r);
+            std::vector<size_t> sub_expected = {42};
+            for (size_t offset : expected) {
+                if (offset >= begin && offset < end)
+                    sub_expected.push_back(offset - begin);
+            }
+            CHECK(r == sub_expected);
+        }
+    }
+
+    std::vector<size_t> r;
+    find_newlines(std::string(64, '\n'), r);
+    CHECK(r.size() == 64);
+    CHECK(r.back() == 63);
+
+    // blocks without any newline are skipped
+    r.clear();
+    find_newlines(std::string(300, 'x') + '\n' + std::string(1000, 'x') + '\n', r);
+    CHECK(r == std::vector<size_t>{300, 1301});
+}
+
+}  // namespace komankondi